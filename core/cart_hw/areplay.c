@@ -61,7 +61,7 @@ void areplay_init(void)
   action_replay.enabled = action_replay.status = 0;
 
   /* try to load Action Replay ROM file (max. 64KB) */
-  if (load_archive(AR_ROM, cart.lockrom, 0x10000, NULL) > 0)
+  if (load_bios_archive(AR_ROM, cart.lockrom, 0x10000, NULL) > 0)
   {
     /* detect Action Replay board type */
     if (!memcmp(cart.lockrom + 0x120, "ACTION REPLAY   ", 16)) 
@@ -61,7 +61,7 @@ void ggenie_init(void)
   ggenie.enabled = 0;
 
   /* Try to load Game Genie ROM file (32KB) */
-  if (load_archive(GG_ROM, cart.lockrom, 0x8000, NULL) > 0)
+  if (load_bios_archive(GG_ROM, cart.lockrom, 0x8000, NULL) > 0)
   {
 #ifdef LSB_FIRST
     int i;
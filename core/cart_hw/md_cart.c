@@ -271,6 +271,79 @@ static const md_entry_t rom_database[] =
   {0xffff,0x3632,0x20,0x20,{{0x00,0x00,0x00,0x00},{0xffffff,0xffffff,0xffffff,0xffffff},{0x000000,0x000000,0x000000,0x000000},0,0,NULL,m68k_unused_8_w,topshooter_r,topshooter_w}}
 };
 
+#define ROM_DATABASE_SIZE ((int)(sizeof(rom_database)/sizeof(md_entry_t)))
+
+/* database entries sorted by checksums (initialized on first search) */
+static uint16 rom_database_index[ROM_DATABASE_SIZE];
+static int rom_database_sorted = 0;
+
+#define MD_ENTRY_KEY(i) (((uint32)rom_database[i].chk_1 << 16) | rom_database[i].chk_2)
+
+static int md_entry_cmp(const void *p1, const void *p2)
+{
+  int i = *(const uint16 *)p1;
+  int j = *(const uint16 *)p2;
+
+  if (MD_ENTRY_KEY(i) != MD_ENTRY_KEY(j))
+  {
+    return (MD_ENTRY_KEY(i) < MD_ENTRY_KEY(j)) ? -1 : 1;
+  }
+
+  /* keep database order for identical checksums (first entry is used) */
+  return i - j;
+}
+
+/* search for game into database (last result is cached) */
+static const md_entry_t *md_cart_find(uint16 chk_1, uint16 chk_2)
+{
+  static const md_entry_t *last_entry = NULL;
+  static uint32 last_key = 0;
+  static int last_valid = 0;
+
+  uint32 key = ((uint32)chk_1 << 16) | chk_2;
+  int lo = 0, hi = ROM_DATABASE_SIZE;
+
+  if (!rom_database_sorted)
+  {
+    for (lo = 0; lo < ROM_DATABASE_SIZE; lo++)
+    {
+      rom_database_index[lo] = lo;
+    }
+    qsort(rom_database_index, ROM_DATABASE_SIZE, sizeof(uint16), md_entry_cmp);
+    rom_database_sorted = 1;
+    lo = 0;
+  }
+
+  if (last_valid && (key == last_key))
+  {
+    return last_entry;
+  }
+
+  /* first entry with matching checksums */
+  while (lo < hi)
+  {
+    int mid = (lo + hi) >> 1;
+    if (MD_ENTRY_KEY(rom_database_index[mid]) < key)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  last_entry = NULL;
+  if ((lo < ROM_DATABASE_SIZE) && (MD_ENTRY_KEY(rom_database_index[lo]) == key))
+  {
+    last_entry = &rom_database[rom_database_index[lo]];
+  }
+
+  last_key = key;
+  last_valid = 1;
+  return last_entry;
+}
+
 
 /************************************************************
           Cart Hardware initialization 
@@ -279,6 +352,7 @@ static const md_entry_t rom_database[] =
 void md_cart_init(void)
 {
   int i;
+  const md_entry_t *entry;
 
   /***************************************************************************************************************
                 CARTRIDGE ROM MIRRORING                                                                                   
@@ -474,37 +548,32 @@ void md_cart_init(void)
   }
 
   /* search for game into database */
-  for (i=0; i<(sizeof(rom_database)/sizeof(md_entry_t)); i++)
+  entry = md_cart_find(rominfo.checksum, rominfo.realchecksum);
+
+  /* known cart found ! */
+  if (entry)
   {
-    /* known cart found ! */
-    if ((rominfo.checksum == rom_database[i].chk_1) &&
-        (rominfo.realchecksum == rom_database[i].chk_2))
-    {
-      int j = rom_database[i].bank_start;
+    int j = entry->bank_start;
 
-      /* retrieve hardware information */
-      memcpy(&cart.hw, &(rom_database[i].cart_hw), sizeof(cart.hw));
+    /* retrieve hardware information */
+    memcpy(&cart.hw, &(entry->cart_hw), sizeof(cart.hw));
 
-      /* initialize memory handlers for $400000-$7FFFFF region */
-      while (j <= rom_database[i].bank_end)
+    /* initialize memory handlers for $400000-$7FFFFF region */
+    while (j <= entry->bank_end)
+    {
+      if (cart.hw.regs_r)
       {
-        if (cart.hw.regs_r)
-        {
-          m68k.memory_map[j].read8    = cart.hw.regs_r;
-          m68k.memory_map[j].read16   = cart.hw.regs_r;
-          zbank_memory_map[j].read    = cart.hw.regs_r;
-        }
-        if (cart.hw.regs_w)
-        {
-          m68k.memory_map[j].write8   = cart.hw.regs_w;
-          m68k.memory_map[j].write16  = cart.hw.regs_w;
-          zbank_memory_map[j].write   = cart.hw.regs_w;
-        }
-        j++;
+        m68k.memory_map[j].read8    = cart.hw.regs_r;
+        m68k.memory_map[j].read16   = cart.hw.regs_r;
+        zbank_memory_map[j].read    = cart.hw.regs_r;
       }
-
-      /* leave loop */
-      break;
+      if (cart.hw.regs_w)
+      {
+        m68k.memory_map[j].write8   = cart.hw.regs_w;
+        m68k.memory_map[j].write16  = cart.hw.regs_w;
+        zbank_memory_map[j].write   = cart.hw.regs_w;
+      }
+      j++;
     }
   }
 
@@ -759,13 +828,13 @@ void md_cart_init(void)
       if (cart.romsize > 0x400000) break;
 
       /* try to load Sonic & Knuckles ROM file (2MB) */
-      if (load_archive(SK_ROM, cart.rom + 0x400000, 0x200000, NULL) == 0x200000)
+      if (load_bios_archive(SK_ROM, cart.rom + 0x400000, 0x200000, NULL) == 0x200000)
       {
         /* check ROM header */
         if (!memcmp(cart.rom + 0x400000 + 0x120, "SONIC & KNUCKLES",16))
         {
           /* try to load Sonic 2 & Knuckles upmem ROM file (256KB) */
-          if (load_archive(SK_UPMEM, cart.rom + 0x600000, 0x40000, NULL) == 0x40000)
+          if (load_bios_archive(SK_UPMEM, cart.rom + 0x600000, 0x40000, NULL) == 0x40000)
           {
             /* $000000-$1FFFFF is mapped to S&K ROM */
             for (i=0x00; i<0x20; i++)
@@ -906,6 +975,16 @@ void md_cart_reset(int hard_reset)
   }
 }
 
+/* hardware that need to be released on exit */
+void md_cart_shutdown(void)
+{
+  /* Paprium hardware */
+  if (cart.special & HW_PAPRIUM)
+  {
+    paprium_shutdown();
+  }
+}
+
 int md_cart_context_save(uint8 *state)
 {
   int i;
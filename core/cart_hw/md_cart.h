@@ -97,6 +97,7 @@ typedef struct
 /* Function prototypes */
 extern void md_cart_init(void);
 extern void md_cart_reset(int hard_reset);
+extern void md_cart_shutdown(void);
 extern int md_cart_context_save(uint8 *state);
 extern int md_cart_context_load(uint8 *state);
 
@@ -15,22 +15,45 @@ Project Little Man
 
 #define MINIMP3_IMPLEMENTATION
 #include "minimp3_ex.h"
+#include "mthread.h"
 
 
-static mp3dec_t paprium_mp3d;
-static mp3dec_file_info_t paprium_mp3d_info;
+/* music tracks are streamed: slot 0 = current track, slots 1-4 = boss tracks (kept open) */
+#define PAPRIUM_MP3_SLOTS 5
 
-static mp3dec_t paprium_mp3d_boss1;
-static mp3dec_file_info_t paprium_mp3d_info_boss1;
+/* decoded samples block (interleaved stereo samples) */
+#define PAPRIUM_MP3_BLOCK (1024*2)
 
-static mp3dec_t paprium_mp3d_boss2;
-static mp3dec_file_info_t paprium_mp3d_info_boss2;
+static mp3dec_ex_t paprium_mp3[PAPRIUM_MP3_SLOTS];
+static int paprium_mp3_opened[PAPRIUM_MP3_SLOTS];
+static char paprium_mp3_name[512];
 
-static mp3dec_t paprium_mp3d_boss3;
-static mp3dec_file_info_t paprium_mp3d_info_boss3;
+static mp3d_sample_t paprium_mp3_pcm[PAPRIUM_MP3_BLOCK];
+static int paprium_mp3_idx, paprium_mp3_len, paprium_mp3_end, paprium_mp3_size;
 
-static mp3dec_t paprium_mp3d_boss4;
-static mp3dec_file_info_t paprium_mp3d_info_boss4;
+#ifdef USE_THREADS
+/* read-ahead buffer size (about 1s of stereo 48 kHz samples) */
+#define PAPRIUM_MP3_RING (0x20000)
+
+static struct
+{
+	mt_thread_t thread;
+	mt_mutex_t lock;
+	mt_cond_t cond;  /* wakes up decoder thread */
+	mt_cond_t idle;  /* decoder thread stopped using track streams */
+	int started, quit;
+
+	int busy;        /* decoder thread is using track streams (opened outside lock) */
+	int slot;        /* streamed slot (-1 = none) */
+	int reopen;      /* current track file needs to be opened */
+	int opened;      /* current track file was opened */
+	int pos;         /* stream position of first buffered sample */
+	int target;      /* stream position of next decoded sample */
+	int total;       /* streamed track length */
+	int head, tail, count;
+	mp3d_sample_t ring[PAPRIUM_MP3_RING];
+} paprium_stream;
+#endif
 
 static int paprium_track_last;
 extern char g_rom_dir[256];
@@ -41,6 +64,12 @@ extern char g_rom_dir[256];
 #define PAPRIUM_BOSS3 0x22
 #define PAPRIUM_BOSS4 0x23
 
+/* audio is rendered by blocks of samples (must stay below echo delay) */
+#define PAPRIUM_AUDIO_BLOCK 1024
+
+/* echo ring size (samples) */
+#define PAPRIUM_ECHO_SIZE (48000/6)
+
 
 static int skip_boot1 = 1;
 
@@ -155,6 +184,346 @@ uint8 paprium_volume_table[256] =
 };
 
 
+static int paprium_mp3_slot(int track)
+{
+	switch( track ) {
+	case PAPRIUM_BOSS1: return 1;
+	case PAPRIUM_BOSS2: return 2;
+	case PAPRIUM_BOSS3: return 3;
+	case PAPRIUM_BOSS4: return 4;
+	}
+
+	return 0;
+}
+
+
+static void paprium_mp3_close(int slot)
+{
+	if( paprium_mp3_opened[slot] )
+		mp3dec_ex_close(&paprium_mp3[slot]);
+
+	paprium_mp3_opened[slot] = 0;
+}
+
+
+static int paprium_mp3_open(int slot, const char *name)
+{
+	paprium_mp3_close(slot);
+
+	if( mp3dec_ex_open(&paprium_mp3[slot], name, MP3D_SEEK_TO_SAMPLE) )
+		return 0;
+
+	if( !paprium_mp3[slot].samples ) {
+		mp3dec_ex_close(&paprium_mp3[slot]);
+		return 0;
+	}
+
+	paprium_mp3_opened[slot] = 1;
+	return 1;
+}
+
+
+/* decode samples from track position (track is looped) */
+static int paprium_mp3_decode(int slot, int pos, mp3d_sample_t *dst, int count)
+{
+	mp3dec_ex_t *dec = paprium_mp3 + slot;
+	int done = 0;
+
+	if( !paprium_mp3_opened[slot] )
+		return 0;
+
+	if( dec->cur_sample != (uint64_t) pos )
+		mp3dec_ex_seek(dec, pos);
+
+	while( done < count ) {
+		int len = mp3dec_ex_read(dec, dst + done, count - done);
+
+		done += len;
+
+		/* end of track: loop */
+		if( dec->cur_sample >= dec->samples )
+			mp3dec_ex_seek(dec, 0);
+		else if( len == 0 )
+			break;
+	}
+
+	return done;
+}
+
+
+#ifdef USE_THREADS
+/* Decoder thread only reads ahead: samples are always taken from the */
+/* emulation thread stream position, so output does not depend on    */
+/* thread timings. Track streams are only used by one thread at once  */
+/* (emulation thread waits until decoder thread is not busy).         */
+static void paprium_stream_thread(void *arg)
+{
+	static mp3d_sample_t chunk[PAPRIUM_MP3_BLOCK];
+	static char name[512];
+
+	mt_mutex_lock(&paprium_stream.lock);
+
+	while( !paprium_stream.quit ) {
+		int slot = paprium_stream.slot;
+		int target, len, i;
+
+		/* open new track file (slow part of track changes) */
+		if( paprium_stream.reopen ) {
+			int opened;
+
+			paprium_stream.reopen = 0;
+			paprium_stream.busy = 1;
+			strcpy(name, paprium_mp3_name);
+
+			mt_mutex_unlock(&paprium_stream.lock);
+			opened = paprium_mp3_open(0, name);
+			mt_mutex_lock(&paprium_stream.lock);
+
+			/* result is discarded if another track file was requested in the meantime */
+			if( !paprium_stream.reopen )
+				paprium_stream.opened = opened;
+
+			paprium_stream.busy = 0;
+			mt_cond_broadcast(&paprium_stream.idle);
+			continue;
+		}
+
+		if( slot < 0 || (paprium_stream.count + PAPRIUM_MP3_BLOCK) > PAPRIUM_MP3_RING ) {
+			mt_cond_wait(&paprium_stream.cond, &paprium_stream.lock);
+			continue;
+		}
+
+		target = paprium_stream.target;
+		paprium_stream.busy = 1;
+
+		mt_mutex_unlock(&paprium_stream.lock);
+		len = paprium_mp3_decode(slot, target, chunk, PAPRIUM_MP3_BLOCK);
+		mt_mutex_lock(&paprium_stream.lock);
+
+		paprium_stream.busy = 0;
+		mt_cond_broadcast(&paprium_stream.idle);
+
+		/* discard decoded samples if stream was restarted in the meantime */
+		if( paprium_stream.reopen || paprium_stream.slot != slot || paprium_stream.target != target )
+			continue;
+
+		if( len == 0 ) {
+			paprium_stream.slot = -1;
+			continue;
+		}
+
+		for( i = 0; i < len; i++ ) {
+			paprium_stream.ring[paprium_stream.head] = chunk[i];
+			paprium_stream.head = (paprium_stream.head + 1) % PAPRIUM_MP3_RING;
+		}
+
+		paprium_stream.count += len;
+		paprium_stream.target = (target + len) % paprium_stream.total;
+	}
+
+	mt_mutex_unlock(&paprium_stream.lock);
+}
+
+
+/* start decoder thread on first use (returns 0 if not available) */
+static int paprium_stream_init(void)
+{
+	if( !paprium_stream.started ) {
+		mt_mutex_init(&paprium_stream.lock);
+		mt_cond_init(&paprium_stream.cond);
+		mt_cond_init(&paprium_stream.idle);
+		paprium_stream.quit = 0;
+		paprium_stream.busy = 0;
+		paprium_stream.slot = -1;
+		paprium_stream.reopen = 0;
+		paprium_stream.opened = 0;
+		paprium_stream.head = paprium_stream.tail = paprium_stream.count = 0;
+		paprium_stream.started = 1;
+
+		if( !mt_thread_create(&paprium_stream.thread, paprium_stream_thread, NULL) ) {
+			mt_cond_destroy(&paprium_stream.idle);
+			mt_cond_destroy(&paprium_stream.cond);
+			mt_mutex_destroy(&paprium_stream.lock);
+			paprium_stream.started = -1;
+		}
+	}
+
+	return (paprium_stream.started > 0);
+}
+
+
+/* request current track file opening by decoder thread */
+static void paprium_stream_open(const char *name)
+{
+	mt_mutex_lock(&paprium_stream.lock);
+
+	/* same track file already opened (or being opened) */
+	if( (paprium_stream.reopen || paprium_stream.opened) && !strcmp(name, paprium_mp3_name) ) {
+		mt_mutex_unlock(&paprium_stream.lock);
+		return;
+	}
+
+	strcpy(paprium_mp3_name, name);
+	paprium_stream.reopen = 1;
+	paprium_stream.opened = 0;
+
+	/* stop reading ahead previous track */
+	if( paprium_stream.slot == 0 ) {
+		paprium_stream.slot = -1;
+		paprium_stream.head = paprium_stream.tail = paprium_stream.count = 0;
+	}
+
+	mt_cond_signal(&paprium_stream.cond);
+	mt_mutex_unlock(&paprium_stream.lock);
+}
+
+
+/* read buffered samples, or decode them if stream position is not buffered */
+static int paprium_stream_read(int slot, int pos, mp3d_sample_t *dst, int count)
+{
+	int len, i;
+
+	mt_mutex_lock(&paprium_stream.lock);
+
+	/* wait for track file opening, or for block being decoded if requested samples are not buffered */
+	while( paprium_stream.reopen || (paprium_stream.busy &&
+	       !(paprium_stream.slot == slot && paprium_stream.pos == pos && paprium_stream.count >= 2)) )
+		mt_cond_wait(&paprium_stream.idle, &paprium_stream.lock);
+
+	if( paprium_stream.slot == slot && paprium_stream.pos == pos && paprium_stream.count >= 2 ) {
+		len = (count < paprium_stream.count) ? count : paprium_stream.count;
+		len &= ~1;
+
+		for( i = 0; i < len; i++ ) {
+			dst[i] = paprium_stream.ring[paprium_stream.tail];
+			paprium_stream.tail = (paprium_stream.tail + 1) % PAPRIUM_MP3_RING;
+		}
+
+		paprium_stream.count -= len;
+		paprium_stream.pos = (pos + len) % paprium_stream.total;
+		paprium_mp3_size = paprium_stream.total;
+
+		mt_cond_signal(&paprium_stream.cond);
+		mt_mutex_unlock(&paprium_stream.lock);
+
+		return len;
+	}
+
+	/* track change or savestate load: restart stream from this position */
+	paprium_stream.slot = -1;
+	paprium_stream.head = paprium_stream.tail = paprium_stream.count = 0;
+
+	if( !paprium_mp3_opened[slot] ) {
+		/* track file could not be opened */
+		if( slot == 0 && paprium_mp3_name[0] )
+			paprium_s.music_track = 0;
+
+		mt_mutex_unlock(&paprium_stream.lock);
+		return 0;
+	}
+
+	/* decode samples on emulation thread */
+	paprium_mp3_size = (int) paprium_mp3[slot].samples;
+	pos %= paprium_mp3_size;
+	len = paprium_mp3_decode(slot, pos, dst, count) & ~1;
+
+	/* read ahead following samples */
+	if( len > 0 ) {
+		paprium_stream.slot = slot;
+		paprium_stream.total = paprium_mp3_size;
+		paprium_stream.pos = paprium_stream.target = (pos + len) % paprium_mp3_size;
+		mt_cond_signal(&paprium_stream.cond);
+	}
+
+	mt_mutex_unlock(&paprium_stream.lock);
+
+	return len;
+}
+#endif
+
+
+void paprium_shutdown(void)
+{
+	int slot;
+
+#ifdef USE_THREADS
+	if( paprium_stream.started > 0 ) {
+		mt_mutex_lock(&paprium_stream.lock);
+		paprium_stream.quit = 1;
+		mt_cond_signal(&paprium_stream.cond);
+		mt_mutex_unlock(&paprium_stream.lock);
+
+		mt_thread_join(paprium_stream.thread);
+		mt_cond_destroy(&paprium_stream.idle);
+		mt_cond_destroy(&paprium_stream.cond);
+		mt_mutex_destroy(&paprium_stream.lock);
+	}
+
+	paprium_stream.started = 0;
+#endif
+
+	for( slot = 0; slot < PAPRIUM_MP3_SLOTS; slot++ )
+		paprium_mp3_close(slot);
+}
+
+
+/* read current track samples from paprium_s.mp3_ptr position (returns 0 if not available) */
+static int paprium_mp3_read(mp3d_sample_t *dst, int count)
+{
+	int slot = paprium_mp3_slot(paprium_s.music_track);
+
+#ifdef USE_THREADS
+	if( paprium_stream_init() )
+		return paprium_stream_read(slot, paprium_s.mp3_ptr, dst, count);
+#endif
+
+	/* synchronous decoding */
+	if( !paprium_mp3_opened[slot] )
+		return 0;
+
+	paprium_mp3_size = (int) paprium_mp3[slot].samples;
+	return paprium_mp3_decode(slot, paprium_s.mp3_ptr % paprium_mp3_size, dst, count) & ~1;
+}
+
+
+/* next music samples (left channel) */
+static void paprium_mp3_block(int *dst, int count)
+{
+	int i, n;
+
+	while( count > 0 ) {
+		/* refill decoded samples block (discarded on savestate load) */
+		if( paprium_mp3_idx >= paprium_mp3_len || paprium_s.mp3_ptr != paprium_mp3_end ) {
+			paprium_mp3_idx = 0;
+			paprium_mp3_len = paprium_mp3_read(paprium_mp3_pcm, PAPRIUM_MP3_BLOCK);
+
+			/* track not available: output silence for a short while */
+			if( paprium_mp3_len == 0 ) {
+				memset(paprium_mp3_pcm, 0, 256 * 2 * sizeof(mp3d_sample_t));
+				paprium_mp3_len = 256 * 2;
+				paprium_mp3_size = 0;
+			}
+		}
+
+		n = (paprium_mp3_len - paprium_mp3_idx + 1) / 2;
+		if( n > count ) n = count;
+
+		for( i = 0; i < n; i++ )
+			dst[i] = paprium_mp3_pcm[paprium_mp3_idx + i*2];
+
+		paprium_mp3_idx += n * 2;
+		dst += n;
+		count -= n;
+
+		/* track position follows consumed samples */
+		if( paprium_mp3_size )
+			paprium_s.mp3_ptr = (paprium_s.mp3_ptr + n * 2) % paprium_mp3_size;
+
+		paprium_mp3_end = paprium_s.mp3_ptr;
+	}
+}
+
+
 static void paprium_load_mp3(int track, int reload)
 {
 	static char name[512];
@@ -228,8 +597,25 @@ static void paprium_load_mp3(int track, int reload)
 
 	paprium_s.music_tick = 0;
 
-	if( track != PAPRIUM_BOSS1 && track != PAPRIUM_BOSS2 && track != PAPRIUM_BOSS3 && track != PAPRIUM_BOSS4 ) {
-		if( mp3dec_load(&paprium_mp3d, name, &paprium_mp3d_info, NULL, NULL) ) {
+	/* discard previously decoded samples */
+	paprium_mp3_idx = paprium_mp3_len = 0;
+
+	if( paprium_mp3_slot(track) == 0 ) {
+#ifdef USE_THREADS
+		/* track file is opened by decoder thread (music_track is cleared on first read if it failed) */
+		if( paprium_stream_init() ) {
+			paprium_stream_open(name);
+			return;
+		}
+#endif
+
+		/* same track file already opened */
+		if( paprium_mp3_opened[0] && !strcmp(name, paprium_mp3_name) )
+			return;
+
+		strcpy(paprium_mp3_name, name);
+
+		if( !paprium_mp3_open(0, name) ) {
 			paprium_s.music_track = 0;
 			return;
 		}
@@ -247,17 +633,18 @@ static void paprium_load_mp3_boss()
 	sprintf(error_str, "%s/paprium/", g_rom_dir);
 #endif
 
+	/* boss tracks are kept open for instant switching */
 	sprintf(name, "%s04 Drumbass Boss.mp3", error_str);
-	mp3dec_load(&paprium_mp3d_boss1, name, &paprium_mp3d_info_boss1, NULL, NULL);
+	paprium_mp3_open(1, name);
 
 	sprintf(name, "%s22 Hardcore BP1.mp3", error_str);
-	mp3dec_load(&paprium_mp3d_boss2, name, &paprium_mp3d_info_boss2, NULL, NULL);
+	paprium_mp3_open(2, name);
 
 	sprintf(name, "%s11 Hardcore BP2.mp3", error_str);
-	mp3dec_load(&paprium_mp3d_boss3, name, &paprium_mp3d_info_boss3, NULL, NULL);
+	paprium_mp3_open(3, name);
 
 	sprintf(name, "%s38 Hardcore BP3.mp3", error_str);
-	mp3dec_load(&paprium_mp3d_boss4, name, &paprium_mp3d_info_boss4, NULL, NULL);
+	paprium_mp3_open(4, name);
 }
 
 
@@ -448,246 +835,207 @@ end:
 }
 
 
-static void paprium_music_synth(int *out_l, int *out_r)
+static void paprium_music_synth(int *out_l, int *out_r, int samples)
 {
-	int ch;
-	int l = 0, r = 0;
+	int n;
 
 
-#if 1
 	if( paprium_s.music_track ) {
-		if( paprium_s.music_track == PAPRIUM_BOSS1 ) {
-			l = paprium_mp3d_info_boss1.buffer[paprium_s.mp3_ptr];
-			r = paprium_mp3d_info_boss1.buffer[paprium_s.mp3_ptr];
-		}
-		else if( paprium_s.music_track == PAPRIUM_BOSS2 ) {
-			l = paprium_mp3d_info_boss2.buffer[paprium_s.mp3_ptr];
-			r = paprium_mp3d_info_boss2.buffer[paprium_s.mp3_ptr];
-		}
-		else if( paprium_s.music_track == PAPRIUM_BOSS3 ) {
-			l = paprium_mp3d_info_boss3.buffer[paprium_s.mp3_ptr];
-			r = paprium_mp3d_info_boss3.buffer[paprium_s.mp3_ptr];
-		}
-		else if( paprium_s.music_track == PAPRIUM_BOSS4 ) {
-			l = paprium_mp3d_info_boss4.buffer[paprium_s.mp3_ptr];
-			r = paprium_mp3d_info_boss4.buffer[paprium_s.mp3_ptr];
-		}
-		else {
-			l = paprium_mp3d_info.buffer[paprium_s.mp3_ptr];
-			r = paprium_mp3d_info.buffer[paprium_s.mp3_ptr];
-		}
-
-
-		l = (l * paprium_s.music_volume) / 256;
-		r = (r * paprium_s.music_volume) / 256;
-
-
-		paprium_s.music_tick += 0x10000;
-		if( paprium_s.music_tick >= 0x10000 ) {
-			paprium_s.music_tick -= 0x10000;
-
-			paprium_s.mp3_ptr += 2;
-		}
+		int vol = paprium_s.music_volume;
 
+		paprium_mp3_block(out_l, samples);
 
-		if( paprium_s.music_track == PAPRIUM_BOSS1 ) {
-			if( paprium_s.mp3_ptr >= paprium_mp3d_info_boss1.samples)
-				paprium_s.mp3_ptr -= paprium_mp3d_info_boss1.samples;
-		}
-		else if( paprium_s.music_track == PAPRIUM_BOSS2 ) {
-			if( paprium_s.mp3_ptr >= paprium_mp3d_info_boss2.samples)
-				paprium_s.mp3_ptr -= paprium_mp3d_info_boss2.samples;
-		}
-		else if( paprium_s.music_track == PAPRIUM_BOSS3 ) {
-			if( paprium_s.mp3_ptr >= paprium_mp3d_info_boss3.samples)
-				paprium_s.mp3_ptr -= paprium_mp3d_info_boss3.samples;
-		}
-		else if( paprium_s.music_track == PAPRIUM_BOSS4 ) {
-			if( paprium_s.mp3_ptr >= paprium_mp3d_info_boss4.samples)
-				paprium_s.mp3_ptr -= paprium_mp3d_info_boss4.samples;
-		}
-		else {
-			if( paprium_s.mp3_ptr >= paprium_mp3d_info.samples)
-				paprium_s.mp3_ptr -= paprium_mp3d_info.samples;
+		for( n = 0; n < samples; n++ ) {
+			out_l[n] = (out_l[n] * vol) / 256;
+			out_r[n] = out_l[n];
 		}
 	}
+	else {
+		memset(out_l, 0, samples * sizeof(int));
+		memset(out_r, 0, samples * sizeof(int));
+	}
+}
 
-	*out_l = l;
-	*out_r = r;
 
-	return;
-#endif
+/* render one sfx voice samples, returns end of active samples range */
+static int paprium_sfx_fetch(paprium_voice_t *voice, int *dst, int samples, int *first)
+{
+	const int _rates[] = {1,2,4,5,8,9};  /* 48000, 24000, 12000, 9600, 6000, 5333 */
 
+	int rate = _rates[voice->type >> 4] << 16;  /* 16.16 */
+	int depth = voice->type & 0x03;
+	/* voice->type & 0xC0; */
 
-	for( ch = 0; ch < 26; ch++ ) {
-		paprium_voice_t *voice = paprium_s.music + ch;
-		const int _rates[] = {2,4,5,8,9,10};  /* 24000 ?, 12000, 9600, 6000, 5333-?, 4800-? */
+	/* tiny pitch, huge pitch */
+	int step = 0x10000 - ((voice->flags & 0x8000) ? 0x800 : 0) - ((voice->flags & 0x2000) ? 0x8000 : 0);
 
-		int rate = _rates[voice->type] << 16;  /* 16.16 */
-		int vol = voice->volume;
-		int pan = voice->panning;
+	uint8 *sfx = paprium_sfx_ptr + cart.rom;
+	int n, last = 0;
 
-		int sample, sample_l, sample_r;
+	*first = samples;
 
+	for( n = 0; n < samples; n++ ) {
+		int sample;
 
-		//if( ch < 15-1 || ch > 17-1 ) goto next;
 
-#if 0
-		if( ch == 20 ) {
-			sprintf(error_str, "[%d] %X %X\n", ch, voice->ptr, voice->size);
-			log_cb(RETRO_LOG_ERROR, error_str);
-		}
-		else
+		if( voice->size == 0 ) {
+			dst[n] = 0;
 			goto next;
-#endif
-
-
-		if( ((paprium_s.audio_tick % 4) == 0) && voice->duration) {
-			//voice->duration--;
-			if( voice->duration == 0 ) {
-				if( voice->keyon == 1 )  /* hard off */
-					voice->size = 0;
-			}
 		}
 
 
-		if( voice->size == 0 ) goto next;
+		sample = *(uint8 *)(sfx + (voice->ptr^1));
 
+		if( depth == 1 )
+			sample = (((sample & 0xFF) * 65536) / 256) - 32768;
 
-		sample = *(uint8 *)(paprium_wave_ram + (voice->ptr^1));
+		else if( depth == 2 ) {
+			if( voice->count == 0 )
+				sample >>= 4;
 
-		sample = (((sample & 0xFF) * 65536) / 256) - 32768;
-		sample = (sample * vol) / 0x300;
+			sample = (((sample & 0x0F) * 65536) / 16) - 32768;
+		}
 
-		sample_l = (sample * ((pan <= 0x80) ? 0x80 : 0x100 - pan)) / 0x80;
-		sample_r = (sample * ((pan >= 0x80) ? 0x80 : pan)) / 0x80;
+		dst[n] = sample;
 
-		l += sample_l;
-		r += sample_r;
+		/* once stopped, a voice can only restart on the next sample (loop) */
+		if( *first > n ) *first = n;
+		last = n + 1;
 
 
 		voice->time++;
-		voice->tick += 0x10000;
+		voice->tick += step;
 
 
 		if( voice->tick >= rate ) {
 			voice->tick -= rate;
 
+			voice->count++;
 			voice->size--;
-			voice->ptr++;
+
+			if( voice->count >= depth ) {
+				voice->ptr++;
+
+				voice->count = 0;
+			}
 		}
 
 
 next:
 		if( voice->size == 0 ) {
+			voice->count = 0;
+
+			if( voice->loop ) {
+				voice->ptr = (*(uint16 *)(sfx + voice->num*8) << 16) | (*(uint16 *)(sfx + voice->num*8 + 2));
+				voice->size = (*(uint8 *)(sfx + voice->num*8 + 4) << 16) | (*(uint16 *)(sfx + voice->num*8 + 6));
+			}
 		}
 	}
 
-
-	*out_l += l;
-	*out_r += r;
+	return last;
 }
 
 
-static void paprium_sfx_voice(int *out_l, int *out_r)
+static void paprium_sfx_voice(int *out_l, int *out_r, int *echo_l, int *echo_r, int samples)
 {
-	int ch;
-	int l = 0, r = 0;
+	static int sample[PAPRIUM_AUDIO_BLOCK];
+	static int voice_l[PAPRIUM_AUDIO_BLOCK], voice_r[PAPRIUM_AUDIO_BLOCK];
+	static int sfx_l[PAPRIUM_AUDIO_BLOCK], sfx_r[PAPRIUM_AUDIO_BLOCK];
+
+	int ch, n;
+
+	memset(sfx_l, 0, samples * sizeof(int));
+	memset(sfx_r, 0, samples * sizeof(int));
 
 	for( ch = 0; ch < 8; ch++ ) {
 		paprium_voice_t *voice = paprium_s.sfx + ch;
-		const int _rates[] = {1,2,4,5,8,9};  /* 48000, 24000, 12000, 9600, 6000, 5333 */
-
-		int rate = _rates[voice->type >> 4] << 16;  /* 16.16 */
-		int depth = voice->type & 0x03;
-		/* voice->type & 0xC0; */
 
 		int vol = voice->volume;
 		int pan = voice->panning;
+		int pan_l = (pan <= 0x80) ? 0x80 : 0x100 - pan;
+		int pan_r = (pan >= 0x80) ? 0x80 : pan;
 
-		int sample, sample_l, sample_r;
+		int first, last;
 
 
-		if( voice->size == 0 ) goto next;
+		last = paprium_sfx_fetch(voice, sample, samples, &first);
 
+		if( first >= last ) continue;
 
-		sample = *(uint8 *)(cart.rom + paprium_sfx_ptr + (voice->ptr^1));
 
-		if( depth == 1 )
-			sample = (((sample & 0xFF) * 65536) / 256) - 32768;
+		for( n = first; n < last; n++ ) {
+			int s = (sample[n] * vol) / 0x400;
 
-		else if( depth == 2 ) {
-			if( voice->count == 0 )
-				sample >>= 4;
+			voice_l[n] = (s * pan_l) / 0x80;
+			voice_r[n] = (s * pan_r) / 0x80;
 
-			sample = (((sample & 0x0F) * 65536) / 16) - 32768;
+			sfx_l[n] += voice_l[n];
+			sfx_r[n] += voice_r[n];
 		}
 
 
-		sample = (sample * vol) / 0x400;
-
-		sample_l = (sample * ((pan <= 0x80) ? 0x80 : 0x100 - pan)) / 0x80;
-		sample_r = (sample * ((pan >= 0x80) ? 0x80 : pan)) / 0x80;
-
-		l += sample_l;
-		r += sample_r;
-
-
 		if( voice->flags & 0x4000 ) {  /* echo */
-			if( voice->echo & 1 )
-				paprium_s.echo_l[paprium_s.echo_ptr % (48000/6)] += (sample_l * 33) / 100;
-			else
-				paprium_s.echo_r[paprium_s.echo_ptr % (48000/6)] += (sample_r * 33) / 100;
+			if( voice->echo & 1 ) {
+				for( n = first; n < last; n++ )
+					echo_l[n] += (voice_l[n] * 33) / 100;
+			}
+			else {
+				for( n = first; n < last; n++ )
+					echo_r[n] += (voice_r[n] * 33) / 100;
+			}
 		}
 
 
-		if( voice->flags & 0x100 ) {  /* amplify */
-			l = (l * 125) / 100;
-			r = (r * 125) / 100;
+		if( voice->flags & 0x100 ) {  /* amplify (all voices mixed so far) */
+			for( n = first; n < last; n++ ) {
+				sfx_l[n] = (sfx_l[n] * 125) / 100;
+				sfx_r[n] = (sfx_r[n] * 125) / 100;
+			}
 		}
+	}
 
-		voice->time++;
-
-		voice->tick += 0x10000;
-		voice->tick -= (voice->flags & 0x8000) ? 0x800 : 0;  /* tiny pitch */
-		voice->tick -= (voice->flags & 0x2000) ? 0x8000 : 0;  /* huge pitch */
+	for( n = 0; n < samples; n++ ) {
+		out_l[n] += sfx_l[n];
+		out_r[n] += sfx_r[n];
+	}
+}
 
 
-		if( voice->tick >= rate ) {
-			voice->tick -= rate;
+/* add delayed echo samples, starting from ring position */
+static void paprium_echo_read(int *dst, const int *ring, int pos, int count)
+{
+	int i, n = PAPRIUM_ECHO_SIZE - pos;
 
-			voice->count++;
-			voice->size--;
+	if( n > count ) n = count;
 
-			if( voice->count >= depth ) {
-				voice->ptr++;
+	for( i = 0; i < n; i++ )
+		dst[i] += ring[pos + i];
 
-				voice->count = 0;
-			}
-		}
- 
+	for( ; i < count; i++ )
+		dst[i] += ring[i - n];
+}
 
-next:
-		if( voice->size == 0 ) {
-			voice->count = 0;
 
-			if( voice->loop ) {
-				uint8 *sfx = paprium_sfx_ptr + cart.rom;
+/* store echo samples, starting from ring position */
+static void paprium_echo_write(int *ring, const int *src, int pos, int count)
+{
+	int n = PAPRIUM_ECHO_SIZE - pos;
 
-				voice->ptr = (*(uint16 *)(sfx + voice->num*8) << 16) | (*(uint16 *)(sfx + voice->num*8 + 2));
-				voice->size = (*(uint8 *)(sfx + voice->num*8 + 4) << 16) | (*(uint16 *)(sfx + voice->num*8 + 6));
-			}
-		}
-	}
+	if( n > count ) n = count;
 
-	*out_l += l;
-	*out_r += r;
+	memcpy(ring + pos, src, n * sizeof(int));
+	memcpy(ring, src + n, (count - n) * sizeof(int));
 }
 
 
 void paprium_audio(int cycles)
 {
-	int lcv;
+	static int mix_l[PAPRIUM_AUDIO_BLOCK], mix_r[PAPRIUM_AUDIO_BLOCK];
+	static int echo_l[PAPRIUM_AUDIO_BLOCK], echo_r[PAPRIUM_AUDIO_BLOCK];
+	static int out[PAPRIUM_AUDIO_BLOCK * 2];
+
+	int lcv, time;
+	int last[2];
 	int samples = blip_clocks_needed(snd.blips[3], cycles);
 
 
@@ -705,50 +1053,62 @@ void paprium_audio(int cycles)
 	paprium_s.audio_tick++;
 
 
-	for( lcv = 0; lcv < samples; lcv++ ) {
-		int l = 0, r = 0;
-		int ch;
+	last[0] = paprium_s.out_l;
+	last[1] = paprium_s.out_r;
 
+	for( time = 0; time < samples; time += lcv ) {
+		int count = samples - time;
+		int ptr = paprium_s.echo_ptr % PAPRIUM_ECHO_SIZE;
+		int vol = paprium_s.sfx_volume;
+		int gain = (paprium_s.audio_flags & 0x08) ? 2 : 1;
 
-		paprium_s.echo_l[paprium_s.echo_ptr] = 0;
-		paprium_s.echo_r[paprium_s.echo_ptr] = 0;
+		if( count > PAPRIUM_AUDIO_BLOCK )
+			count = PAPRIUM_AUDIO_BLOCK;
 
 
-		paprium_music_synth(&l, &r);
-		paprium_sfx_voice(&l, &r);
+		memset(echo_l, 0, count * sizeof(int));
+		memset(echo_r, 0, count * sizeof(int));
 
+		paprium_music_synth(mix_l, mix_r, count);
+		paprium_sfx_voice(mix_l, mix_r, echo_l, echo_r, count);
 
-		paprium_s.echo_ptr = (paprium_s.echo_ptr+1) % (48000/6);
 
-		l += paprium_s.echo_l[paprium_s.echo_ptr];
-		r += paprium_s.echo_r[paprium_s.echo_ptr];
+		/* delayed echo is read one position ahead, before current samples are stored */
+		paprium_echo_read(mix_l, paprium_s.echo_l, (ptr + 1) % PAPRIUM_ECHO_SIZE, count);
+		paprium_echo_read(mix_r, paprium_s.echo_r, (ptr + 1) % PAPRIUM_ECHO_SIZE, count);
 
+		paprium_echo_write(paprium_s.echo_l, echo_l, ptr, count);
+		paprium_echo_write(paprium_s.echo_r, echo_r, ptr, count);
 
-		l = (l * paprium_s.sfx_volume) / 0x100;
-		r = (r * paprium_s.sfx_volume) / 0x100;
+		paprium_s.echo_ptr = (ptr + count) % PAPRIUM_ECHO_SIZE;
 
 
-		if( paprium_s.audio_flags & 0x08 ) {  /* gain */
-			l = l * 4 / 2;
-			r = r * 4 / 2;
-		}
-
+		for( lcv = 0; lcv < count; lcv++ ) {
+			int l = (mix_l[lcv] * vol) / 0x100;
+			int r = (mix_r[lcv] * vol) / 0x100;
 
-		if( l > 32767 ) l = 32767;
-		else if( l < -32768 ) l = -32768;
+			l *= gain;
+			r *= gain;
 
-		if( r > 32767 ) r = 32767;
-		else if( r < -32768 ) r = -32768;
+			if( l > 32767 ) l = 32767;
+			else if( l < -32768 ) l = -32768;
 
+			if( r > 32767 ) r = 32767;
+			else if( r < -32768 ) r = -32768;
 
-		blip_add_delta_fast(snd.blips[3], lcv, l-paprium_s.out_l, r-paprium_s.out_r);
+			out[lcv*2] = l;
+			out[lcv*2+1] = r;
+		}
 
 
-		paprium_s.out_l = l;
-		paprium_s.out_r = r;
+		blip_add_samples(snd.blips[3], time, out, count, last);
 	}
 
 
+	paprium_s.out_l = last[0];
+	paprium_s.out_r = last[1];
+
+
 	paprium_music_sheet();
 
 
@@ -2850,12 +3210,9 @@ static void paprium_reset()
 {
 	paprium_init();
 
-	mp3dec_init(&paprium_mp3d);
-
-	mp3dec_init(&paprium_mp3d_boss1);
-	mp3dec_init(&paprium_mp3d_boss2);
-	mp3dec_init(&paprium_mp3d_boss3);
-	mp3dec_init(&paprium_mp3d_boss4);
+	paprium_shutdown();
+	paprium_mp3_name[0] = 0;
+	paprium_mp3_idx = paprium_mp3_len = 0;
 	paprium_load_mp3_boss();
 
 
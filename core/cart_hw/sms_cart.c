@@ -443,6 +443,12 @@ static const rominfo_t game_list[] =
   {0x07301F83, 0, 1, 0, MAPPER_SEGA, SYSTEM_PBC, REGION_JAPAN_NTSC}  /* Phantasy Star [Megadrive] (J) */
 };
 
+#define GAME_LIST_SIZE ((int)(sizeof(game_list) / sizeof(rominfo_t)))
+
+/* game list entries sorted by CRC (initialized on first search) */
+static uint16 game_list_index[GAME_LIST_SIZE];
+static int game_list_sorted = 0;
+
 /* Cartridge & BIOS ROM hardware */
 static romhw_t cart_rom;
 static romhw_t bios_rom;
@@ -488,12 +494,88 @@ static unsigned char read_mapper_korea_8k(unsigned int address);
 static unsigned char read_mapper_default(unsigned int address);
 static unsigned char read_mapper_none(unsigned int address);
 
+static int game_list_cmp(const void *p1, const void *p2)
+{
+  int i = *(const uint16 *)p1;
+  int j = *(const uint16 *)p2;
+
+  if (game_list[i].crc != game_list[j].crc)
+  {
+    return (game_list[i].crc < game_list[j].crc) ? -1 : 1;
+  }
+
+  /* last entry in game list is used for identical CRC */
+  return j - i;
+}
+
+/* game CRC (computed once for each loaded ROM) */
+static uint32 sms_cart_crc(void)
+{
+  if (!rominfo.crc_valid)
+  {
+    rominfo.crc = crc32(0, cart.rom, cart.romsize);
+    rominfo.crc_valid = 1;
+  }
+
+  return rominfo.crc;
+}
+
+/* search for game into database (last result is cached) */
+static const rominfo_t *sms_cart_find(uint32 crc)
+{
+  static const rominfo_t *last_entry = NULL;
+  static uint32 last_crc = 0;
+  static int last_valid = 0;
+
+  int lo = 0, hi = GAME_LIST_SIZE;
+
+  if (!game_list_sorted)
+  {
+    for (lo = 0; lo < GAME_LIST_SIZE; lo++)
+    {
+      game_list_index[lo] = lo;
+    }
+    qsort(game_list_index, GAME_LIST_SIZE, sizeof(uint16), game_list_cmp);
+    game_list_sorted = 1;
+    lo = 0;
+  }
+
+  if (last_valid && (crc == last_crc))
+  {
+    return last_entry;
+  }
+
+  /* first entry with matching CRC */
+  while (lo < hi)
+  {
+    int mid = (lo + hi) >> 1;
+    if (game_list[game_list_index[mid]].crc < crc)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  last_entry = NULL;
+  if ((lo < GAME_LIST_SIZE) && (game_list[game_list_index[lo]].crc == crc))
+  {
+    last_entry = &game_list[game_list_index[lo]];
+  }
+
+  last_crc = crc;
+  last_valid = 1;
+  return last_entry;
+}
+
 void sms_cart_init(void)
 {
-  int i = sizeof(game_list) / sizeof(rominfo_t) - 1;
+  const rominfo_t *entry;
 
   /* game CRC */
-  uint32 crc = crc32(0, cart.rom, cart.romsize);
+  uint32 crc = sms_cart_crc();
 
   /* unmapped memory return $FF on read (mapped to unused cartridge areas $510000-$5103FF & $510400-$5107FF) */
   memset(cart.rom + 0x510000, 0xFF, 0x800);
@@ -520,45 +602,39 @@ void sms_cart_init(void)
   }
 
   /* auto-detect game settings */
-  do
+  entry = sms_cart_find(crc);
+  if (entry)
   {
-    if (crc == game_list[i].crc)
-    {
-      /* auto-detect cartridge mapper */
-      cart_rom.mapper = game_list[i].mapper;
+    /* auto-detect cartridge mapper */
+    cart_rom.mapper = entry->mapper;
 
-      /* auto-detect required peripherals */
-      if (game_list[i].peripheral)
+    /* auto-detect required peripherals */
+    if (entry->peripheral)
+    {
+      /* save current input settings */
+      if (old_system[0] == -1)
       {
-        /* save current input settings */
-        if (old_system[0] == -1)
-        {
-          old_system[0] = input.system[0];
-        }
-
-        input.system[0] = game_list[i].peripheral;
+        old_system[0] = input.system[0];
       }
 
-      /* auto-detect 3D glasses support */
-      cart.special = game_list[i].g_3d;
+      input.system[0] = entry->peripheral;
+    }
 
-      /* auto-detect system hardware */
-      if (!config.system || ((config.system == SYSTEM_GG) && (game_list[i].system == SYSTEM_GGMS)))
-      {
-        system_hw = game_list[i].system;
-      }
+    /* auto-detect 3D glasses support */
+    cart.special = entry->g_3d;
 
-      /* auto-detect YM2413 chip support in AUTO mode */
-      if (config.ym2413 & 2)
-      {
-        config.ym2413 |= game_list[i].fm;
-      }
+    /* auto-detect system hardware */
+    if (!config.system || ((config.system == SYSTEM_GG) && (entry->system == SYSTEM_GGMS)))
+    {
+      system_hw = entry->system;
+    }
 
-      /* game found, leave loop */
-      break;
+    /* auto-detect YM2413 chip support in AUTO mode */
+    if (config.ym2413 & 2)
+    {
+      config.ym2413 |= entry->fm;
     }
   }
-  while (i--);
 
   /* ROM paging */
   if (cart_rom.mapper < MAPPER_SEGA)
@@ -823,10 +899,10 @@ int sms_cart_ram_size(void)
 
 int sms_cart_region_detect(void)
 {
-  int i = sizeof(game_list) / sizeof(rominfo_t) - 1;
+  const rominfo_t *entry;
 
   /* compute CRC */
-  uint32 crc = crc32(0, cart.rom, cart.romsize);
+  uint32 crc = sms_cart_crc();
 
   /* Turma da Mnica em: O Resgate & Wonder Boy III enable FM support on japanese hardware only */
   if (config.ym2413 && ((crc == 0x22CCA9BB) || (crc == 0x679E1676)))
@@ -835,14 +911,11 @@ int sms_cart_region_detect(void)
   }
 
   /* game database */
-  do
+  entry = sms_cart_find(crc);
+  if (entry)
   {
-    if (crc == game_list[i].crc)
-    {
-      return game_list[i].region;
-    }
+    return entry->region;
   }
-  while(i--);
 
   /* Mark-III hardware */
   if (config.system == SYSTEM_MARKIII)
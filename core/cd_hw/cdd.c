@@ -37,6 +37,7 @@
  ****************************************************************************************/
 #include "shared.h"
 #include "megasd.h"
+#include "mthread.h"
 
 extern int8 audio_hard_disable;
 
@@ -186,6 +187,682 @@ static void ogg_free(int i)
 }
 #endif
 
+#ifdef USE_THREADS
+/* VORBIS read-ahead decoder */
+/* Decoding and seeking of the current VORBIS track are done by a background thread */
+/* into a ring buffer, cdd_read_audio only copies already decoded PCM data.         */
+#define OGG_STREAM_SIZE   0x20000 /* ring buffer size in bytes (~0.75 sec of stereo 16-bit PCM data) */
+#define OGG_STREAM_CHUNK  0x4000  /* max bytes decoded per ov_read call */
+
+static struct
+{
+  mt_thread_t thread;
+  mt_mutex_t lock;
+  mt_cond_t cond;
+  int started;          /* decoder thread is running */
+  int quit;             /* decoder thread exit request */
+  int busy;             /* decoder thread is accessing VORBIS file */
+  int track;            /* decoded track index (-1 if none) */
+  int seek;             /* pending seek request */
+  int eof;              /* end of VORBIS file reached */
+  int channels;         /* decoded track channels */
+  ogg_int64_t target;   /* seek target offset (in PCM samples) */
+  ogg_int64_t consumed; /* bytes read since last seek */
+  int head;             /* ring buffer write index */
+  int tail;             /* ring buffer read index */
+  int count;            /* bytes available in ring buffer */
+  uint8 ring[OGG_STREAM_SIZE];
+} ogg_stream;
+
+static void ogg_stream_thread(void *arg)
+{
+  static uint8 buffer[OGG_STREAM_CHUNK];
+
+  mt_mutex_lock(&ogg_stream.lock);
+
+  while (!ogg_stream.quit)
+  {
+    int track = ogg_stream.track;
+
+    if (track >= 0)
+    {
+      if (ogg_stream.seek)
+      {
+        ogg_int64_t target = ogg_stream.target;
+        ogg_stream.seek = 0;
+        ogg_stream.busy = 1;
+        mt_mutex_unlock(&ogg_stream.lock);
+
+        /* seek to track position */
+        ov_pcm_seek(&cdd.toc.tracks[track].vf, target);
+
+        mt_mutex_lock(&ogg_stream.lock);
+        ogg_stream.busy = 0;
+        ogg_stream.channels = ov_info(&cdd.toc.tracks[track].vf, -1)->channels;
+        mt_cond_broadcast(&ogg_stream.cond);
+        continue;
+      }
+
+      if (!ogg_stream.eof && (ogg_stream.count < OGG_STREAM_SIZE))
+      {
+        int len, size = OGG_STREAM_SIZE - ogg_stream.count;
+        if (size > OGG_STREAM_CHUNK)
+        {
+          size = OGG_STREAM_CHUNK;
+        }
+
+        ogg_stream.busy = 1;
+        mt_mutex_unlock(&ogg_stream.lock);
+
+        /* decode next samples */
+#ifdef USE_LIBVORBIS
+        len = ov_read(&cdd.toc.tracks[track].vf, (char *)buffer, size, 0, 2, 1, 0);
+#else
+        len = ov_read(&cdd.toc.tracks[track].vf, (char *)buffer, size, 0);
+#endif
+
+        mt_mutex_lock(&ogg_stream.lock);
+        ogg_stream.busy = 0;
+
+        /* discard decoded data if track or position changed meanwhile */
+        if (!ogg_stream.seek && (ogg_stream.track == track))
+        {
+          if (len <= 0)
+          {
+            ogg_stream.eof = 1;
+          }
+          else
+          {
+            /* copy to ring buffer */
+            int first = OGG_STREAM_SIZE - ogg_stream.head;
+            if (first > len)
+            {
+              first = len;
+            }
+            memcpy(ogg_stream.ring + ogg_stream.head, buffer, first);
+            memcpy(ogg_stream.ring, buffer + first, len - first);
+            ogg_stream.head = (ogg_stream.head + len) % OGG_STREAM_SIZE;
+            ogg_stream.count += len;
+          }
+        }
+
+        mt_cond_broadcast(&ogg_stream.cond);
+        continue;
+      }
+    }
+
+    /* wait for next request or free space */
+    mt_cond_wait(&ogg_stream.cond, &ogg_stream.lock);
+  }
+
+  mt_mutex_unlock(&ogg_stream.lock);
+}
+
+static int ogg_stream_seek(int index, ogg_int64_t offset)
+{
+  if (!ogg_stream.started)
+  {
+    mt_mutex_init(&ogg_stream.lock);
+    mt_cond_init(&ogg_stream.cond);
+    ogg_stream.quit = 0;
+    ogg_stream.busy = 0;
+    ogg_stream.track = -1;
+    if (!mt_thread_create(&ogg_stream.thread, ogg_stream_thread, NULL))
+    {
+      /* fallback to synchronous decoding */
+      mt_cond_destroy(&ogg_stream.cond);
+      mt_mutex_destroy(&ogg_stream.lock);
+      return 0;
+    }
+    ogg_stream.started = 1;
+  }
+
+  mt_mutex_lock(&ogg_stream.lock);
+  ogg_stream.track = index;
+  ogg_stream.seek = 1;
+  ogg_stream.target = offset;
+  ogg_stream.consumed = 0;
+  ogg_stream.eof = 0;
+  ogg_stream.head = ogg_stream.tail = ogg_stream.count = 0;
+  mt_cond_broadcast(&ogg_stream.cond);
+  mt_mutex_unlock(&ogg_stream.lock);
+  return 1;
+}
+
+static int ogg_stream_read(uint8 *dst, int size)
+{
+  int first, len;
+
+  mt_mutex_lock(&ogg_stream.lock);
+
+  /* wait until enough data has been decoded */
+  while ((ogg_stream.count < size) && !ogg_stream.eof)
+  {
+    mt_cond_wait(&ogg_stream.cond, &ogg_stream.lock);
+  }
+
+  len = (ogg_stream.count < size) ? ogg_stream.count : size;
+
+  /* copy from ring buffer */
+  first = OGG_STREAM_SIZE - ogg_stream.tail;
+  if (first > len)
+  {
+    first = len;
+  }
+  memcpy(dst, ogg_stream.ring + ogg_stream.tail, first);
+  memcpy(dst + first, ogg_stream.ring, len - first);
+  ogg_stream.tail = (ogg_stream.tail + len) % OGG_STREAM_SIZE;
+  ogg_stream.count -= len;
+  ogg_stream.consumed += len;
+
+  /* wake up decoder thread */
+  mt_cond_broadcast(&ogg_stream.cond);
+  mt_mutex_unlock(&ogg_stream.lock);
+
+  return len;
+}
+
+static ogg_int64_t ogg_stream_tell(void)
+{
+  ogg_int64_t offset;
+  mt_mutex_lock(&ogg_stream.lock);
+  offset = ogg_stream.target;
+  if (ogg_stream.consumed)
+  {
+    /* decoded data is only available once seek has been processed */
+    offset += ogg_stream.consumed / (2 * ogg_stream.channels);
+  }
+  mt_mutex_unlock(&ogg_stream.lock);
+  return offset;
+}
+
+#ifdef DISABLE_MANY_OGG_OPEN_FILES
+static void ogg_stream_stop(void)
+{
+  if (ogg_stream.started)
+  {
+    /* wait until decoder thread releases VORBIS file */
+    mt_mutex_lock(&ogg_stream.lock);
+    ogg_stream.track = -1;
+    ogg_stream.seek = 0;
+    while (ogg_stream.busy)
+    {
+      mt_cond_wait(&ogg_stream.cond, &ogg_stream.lock);
+    }
+    mt_mutex_unlock(&ogg_stream.lock);
+  }
+}
+#endif
+
+static void ogg_stream_shutdown(void)
+{
+  if (ogg_stream.started)
+  {
+    mt_mutex_lock(&ogg_stream.lock);
+    ogg_stream.quit = 1;
+    ogg_stream.track = -1;
+    mt_cond_broadcast(&ogg_stream.cond);
+    mt_mutex_unlock(&ogg_stream.lock);
+    mt_thread_join(ogg_stream.thread);
+    mt_cond_destroy(&ogg_stream.cond);
+    mt_mutex_destroy(&ogg_stream.lock);
+    ogg_stream.started = 0;
+  }
+}
+#endif
+
+#endif
+
+#if defined(USE_LIBCHDR)
+/* Decompressed CHD hunks cache (least recently used hunks are discarded first) */
+/* With default CD-ROM hunk size (8 frames), 32 hunks are about 600 KB which   */
+/* is enough to hold a few seconds of CD-DA playback ahead of current position */
+#define CHD_CACHE_HUNKS 32
+
+/* number of hunks decompressed ahead of current hunk */
+#define CHD_PREFETCH_HUNKS 2
+
+static struct
+{
+  uint8 *data;                    /* decompressed hunks buffer */
+  int hunknum[CHD_CACHE_HUNKS];   /* cached hunk index (-1 if slot is empty) */
+  uint32 used[CHD_CACHE_HUNKS];   /* last access stamp */
+  uint8 busy[CHD_CACHE_HUNKS];    /* hunk decompression is in progress */
+  uint32 stamp;
+  int current;                    /* slot currently referenced by cdd.chd.hunk */
+  int total;                      /* total number of hunks in CHD file */
+  int full;                       /* all hunks are decompressed in memory (pre-cache) */
+#ifdef USE_THREADS
+  int request[CHD_PREFETCH_HUNKS + 1];  /* hunks to decompress ahead (-1 if none) */
+  mt_thread_t thread;
+  mt_mutex_t lock;
+  mt_mutex_t io;
+  mt_cond_t cond;
+  int started;
+  int quit;
+#endif
+} chd_cache;
+
+#ifdef USE_THREADS
+#define chd_cache_lock()    mt_mutex_lock(&chd_cache.lock)
+#define chd_cache_unlock()  mt_mutex_unlock(&chd_cache.lock)
+#else
+#define chd_cache_lock()
+#define chd_cache_unlock()
+#endif
+
+static int chd_cache_find(int hunknum)
+{
+  int i;
+  for (i=0; i<CHD_CACHE_HUNKS; i++)
+  {
+    if (chd_cache.hunknum[i] == hunknum)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static int chd_cache_victim(void)
+{
+  int i, slot = -1;
+
+  /* never discard current hunk or hunks being decompressed */
+  for (i=0; i<CHD_CACHE_HUNKS; i++)
+  {
+    if ((i != chd_cache.current) && !chd_cache.busy[i])
+    {
+      if (chd_cache.hunknum[i] < 0)
+      {
+        return i;
+      }
+
+      if ((slot < 0) || ((chd_cache.stamp - chd_cache.used[i]) > (chd_cache.stamp - chd_cache.used[slot])))
+      {
+        slot = i;
+      }
+    }
+  }
+
+  return slot;
+}
+
+/* decompress one hunk into specified slot (cache lock is released during decompression) */
+static void chd_cache_load(int slot, int hunknum)
+{
+  chd_cache.hunknum[slot] = hunknum;
+  chd_cache.used[slot] = ++chd_cache.stamp;
+  chd_cache.busy[slot] = 1;
+  chd_cache_unlock();
+
+#ifdef USE_THREADS
+  /* CHD decoder is not reentrant */
+  mt_mutex_lock(&chd_cache.io);
+#endif
+  chd_read(cdd.chd.file, hunknum, chd_cache.data + (slot * cdd.chd.hunkbytes));
+#ifdef USE_THREADS
+  mt_mutex_unlock(&chd_cache.io);
+#endif
+
+  chd_cache_lock();
+  chd_cache.busy[slot] = 0;
+#ifdef USE_THREADS
+  mt_cond_broadcast(&chd_cache.cond);
+#endif
+}
+
+#ifdef USE_THREADS
+static void chd_cache_thread(void *arg)
+{
+  int i, hunknum, slot;
+
+  chd_cache_lock();
+
+  while (!chd_cache.quit)
+  {
+    /* look for next requested hunk not yet cached */
+    hunknum = -1;
+    for (i=0; i<=CHD_PREFETCH_HUNKS; i++)
+    {
+      if (chd_cache.request[i] >= 0)
+      {
+        if (chd_cache_find(chd_cache.request[i]) < 0)
+        {
+          hunknum = chd_cache.request[i];
+        }
+        chd_cache.request[i] = -1;
+        if (hunknum >= 0)
+        {
+          break;
+        }
+      }
+    }
+
+    if (hunknum < 0)
+    {
+      mt_cond_wait(&chd_cache.cond, &chd_cache.lock);
+      continue;
+    }
+
+    slot = chd_cache_victim();
+    if (slot >= 0)
+    {
+      chd_cache_load(slot, hunknum);
+    }
+  }
+
+  chd_cache_unlock();
+}
+
+/* request hunks to be decompressed in background (cache lock must be held) */
+static void chd_cache_request(int hunknum)
+{
+  int i;
+
+  if (!chd_cache.started)
+  {
+    return;
+  }
+
+  for (i=0; i<=CHD_PREFETCH_HUNKS; i++)
+  {
+    chd_cache.request[i] = ((hunknum + i) < chd_cache.total) ? (hunknum + i) : -1;
+  }
+
+  mt_cond_broadcast(&chd_cache.cond);
+}
+#endif
+
+static int chd_cache_init(const chd_header *head)
+{
+  int i;
+
+  chd_cache.data = (uint8 *)malloc(CHD_CACHE_HUNKS * head->hunkbytes);
+  if (!chd_cache.data)
+  {
+    return 0;
+  }
+
+  for (i=0; i<CHD_CACHE_HUNKS; i++)
+  {
+    chd_cache.hunknum[i] = -1;
+    chd_cache.used[i] = 0;
+    chd_cache.busy[i] = 0;
+  }
+
+  chd_cache.stamp = 0;
+  chd_cache.current = -1;
+  chd_cache.full = 0;
+  chd_cache.total = head->totalhunks;
+
+#ifdef USE_THREADS
+  for (i=0; i<=CHD_PREFETCH_HUNKS; i++)
+  {
+    chd_cache.request[i] = -1;
+  }
+
+  /* cache still works synchronously if decoder thread can not be started */
+  mt_mutex_init(&chd_cache.lock);
+  mt_mutex_init(&chd_cache.io);
+  mt_cond_init(&chd_cache.cond);
+  chd_cache.quit = 0;
+  chd_cache.started = 1;
+  if (!mt_thread_create(&chd_cache.thread, chd_cache_thread, NULL))
+  {
+    chd_cache.started = 0;
+  }
+#endif
+
+  return 1;
+}
+
+static void chd_cache_shutdown(void)
+{
+#ifdef USE_THREADS
+  if (chd_cache.started)
+  {
+    chd_cache_lock();
+    chd_cache.quit = 1;
+    mt_cond_broadcast(&chd_cache.cond);
+    chd_cache_unlock();
+    mt_thread_join(chd_cache.thread);
+    chd_cache.started = 0;
+  }
+
+  if (chd_cache.data && !chd_cache.full)
+  {
+    mt_cond_destroy(&chd_cache.cond);
+    mt_mutex_destroy(&chd_cache.io);
+    mt_mutex_destroy(&chd_cache.lock);
+  }
+#endif
+
+  if (chd_cache.data)
+  {
+    free(chd_cache.data);
+    chd_cache.data = NULL;
+  }
+
+  chd_cache.full = 0;
+}
+
+#ifdef __LIBRETRO__
+/* Maximal number of threads used to decompress the whole CHD file */
+#define CHD_PRECACHE_THREADS 16
+
+static struct
+{
+  const char *filename;
+  int next;        /* next hunk to decompress */
+  int done;        /* number of decompressed hunks */
+  int progress;    /* last reported progress (in 10% steps) */
+  int error;       /* set if a hunk could not be decompressed */
+#ifdef USE_THREADS
+  mt_mutex_t lock;
+#endif
+} chd_fill;
+
+/* decompress hunks until all have been processed, using given CHD file handle */
+static void chd_fill_hunks(chd_file *file)
+{
+  int hunknum;
+  chd_error err;
+
+  while (1)
+  {
+#ifdef USE_THREADS
+    mt_mutex_lock(&chd_fill.lock);
+#endif
+    if (file == cdd.chd.file)
+    {
+      /* calling thread reports decompression progress */
+      int progress = (chd_fill.done * 10) / chd_cache.total;
+      if (progress > chd_fill.progress)
+      {
+        chd_fill.progress = progress;
+        log_cb(RETRO_LOG_INFO, "Pre-caching %d%% ...\n", progress * 10);
+      }
+    }
+    hunknum = chd_fill.next;
+    if (hunknum < chd_cache.total)
+    {
+      chd_fill.next++;
+    }
+#ifdef USE_THREADS
+    mt_mutex_unlock(&chd_fill.lock);
+#endif
+
+    if (hunknum >= chd_cache.total)
+    {
+      return;
+    }
+
+    /* CHD hunks are independently decoded (self-referencing hunks are resolved internally by each decoder) */
+    err = chd_read(file, hunknum, chd_cache.data + ((size_t)hunknum * cdd.chd.hunkbytes));
+
+#ifdef USE_THREADS
+    mt_mutex_lock(&chd_fill.lock);
+#endif
+    chd_fill.done++;
+    if (err != CHDERR_NONE)
+    {
+      /* abort decompression (remaining hunks are skipped by all threads) */
+      chd_fill.error = 1;
+      chd_fill.next = chd_cache.total;
+    }
+#ifdef USE_THREADS
+    mt_mutex_unlock(&chd_fill.lock);
+#endif
+  }
+}
+
+#ifdef USE_THREADS
+static void chd_fill_thread(void *arg)
+{
+  /* each worker needs its own CHD decoder instance */
+  chd_file *file = NULL;
+  cdStream *fd = cdStreamOpen(chd_fill.filename);
+  if (!fd)
+  {
+    return;
+  }
+
+  if (chd_open_file(fd, CHD_OPEN_READ, NULL, &file) == CHDERR_NONE)
+  {
+    chd_fill_hunks(file);
+  }
+
+  if (file)
+  {
+    chd_close(file);
+  }
+  cdStreamClose(fd);
+}
+#endif
+
+/* decompress whole CHD file in memory (returns 0 if not enough memory or decompression failed) */
+static int chd_cache_fill(const chd_header *head, const char *filename)
+{
+#ifdef USE_THREADS
+  mt_thread_t threads[CHD_PRECACHE_THREADS];
+  int i, count = mt_cpu_count() - 1;
+#endif
+
+  chd_cache.data = (uint8 *)malloc((size_t)head->totalhunks * head->hunkbytes);
+  if (!chd_cache.data)
+  {
+    return 0;
+  }
+
+  chd_cache.total = head->totalhunks;
+  chd_cache.full = 1;
+
+  chd_fill.filename = filename;
+  chd_fill.next = 0;
+  chd_fill.done = 0;
+  chd_fill.progress = 0;
+  chd_fill.error = 0;
+
+#ifdef USE_THREADS
+  /* calling thread also decompresses hunks, using already opened CHD file */
+  if (count > (CHD_PRECACHE_THREADS - 1))
+  {
+    count = CHD_PRECACHE_THREADS - 1;
+  }
+
+  mt_mutex_init(&chd_fill.lock);
+
+  for (i=0; i<count; i++)
+  {
+    if (!mt_thread_create(&threads[i], chd_fill_thread, NULL))
+    {
+      break;
+    }
+  }
+  count = i;
+
+  log_cb(RETRO_LOG_INFO, "Decompressing %d hunks using %d thread(s) ...\n", chd_cache.total, count + 1);
+#endif
+
+  chd_fill_hunks(cdd.chd.file);
+
+#ifdef USE_THREADS
+  for (i=0; i<count; i++)
+  {
+    mt_thread_join(threads[i]);
+  }
+
+  mt_mutex_destroy(&chd_fill.lock);
+#endif
+
+  if (chd_fill.error)
+  {
+    free(chd_cache.data);
+    chd_cache.data = NULL;
+    chd_cache.full = 0;
+    return 0;
+  }
+
+  return 1;
+}
+#endif
+
+/* return specified hunk data, decompressing it if not already cached */
+static uint8 *chd_cache_read(int hunknum)
+{
+  int slot;
+
+  /* whole CHD file is already decompressed */
+  if (chd_cache.full)
+  {
+    return chd_cache.data + ((size_t)hunknum * cdd.chd.hunkbytes);
+  }
+
+  chd_cache_lock();
+
+  slot = chd_cache_find(hunknum);
+  if (slot < 0)
+  {
+    slot = chd_cache_victim();
+    chd_cache_load(slot, hunknum);
+  }
+#ifdef USE_THREADS
+  else
+  {
+    /* wait for background decompression to complete */
+    while (chd_cache.busy[slot])
+    {
+      mt_cond_wait(&chd_cache.cond, &chd_cache.lock);
+    }
+  }
+
+  /* decompress next hunks in advance */
+  chd_cache_request(hunknum + 1);
+#endif
+
+  chd_cache.used[slot] = ++chd_cache.stamp;
+  chd_cache.current = slot;
+
+  chd_cache_unlock();
+
+  return chd_cache.data + (slot * cdd.chd.hunkbytes);
+}
+
+/* hint that specified CHD file offset will be accessed soon (seek target) */
+static void chd_cache_prefetch(int offset)
+{
+#ifdef USE_THREADS
+  if (chd_cache.full)
+  {
+    return;
+  }
+
+  chd_cache_lock();
+  chd_cache_request(offset / cdd.chd.hunkbytes);
+  chd_cache_unlock();
+#endif
+}
 #endif
 
 void cdd_init(int samplerate)
@@ -253,6 +930,14 @@ int cdd_context_save(uint8 *state)
     if (cdd.toc.tracks[cdd.index].vf.seekable)
     {
       /* VORBIS file sample offset */
+#ifdef USE_THREADS
+      if (ogg_stream.started && (ogg_stream.track == cdd.index))
+      {
+        /* decoder thread is running ahead of current read offset */
+        offset = ogg_stream_tell();
+      }
+      else
+#endif
       offset = ov_pcm_tell(&cdd.toc.tracks[cdd.index].vf);
     }
     else
@@ -320,6 +1005,11 @@ int cdd_context_load(uint8 *state, char *version)
       /* check if track index has changed */
       if (index != cdd.index)
       {
+#ifdef USE_THREADS
+        /* make sure decoder thread is not accessing VORBIS files */
+        ogg_stream_stop();
+#endif
+
         /* close previous track VORBIS file structure to save memory */
         if (cdd.toc.tracks[cdd.index].vf.datasource)
         {
@@ -347,6 +1037,9 @@ int cdd_context_load(uint8 *state, char *version)
       if (cdd.toc.tracks[index].vf.seekable)
       {
         /* VORBIS file sample offset */
+#ifdef USE_THREADS
+        if (!ogg_stream_seek(index, offset))
+#endif
         ov_pcm_seek(&cdd.toc.tracks[index].vf, offset);
       }
       else
@@ -410,16 +1103,6 @@ int cdd_load(char *filename, char *header)
       return -1;
     }
 
-#ifdef __LIBRETRO__
-    if (config.cd_precache)
-    {
-      log_cb(RETRO_LOG_INFO, "Pre-caching \"%s\" ...\n", filename);
-      if (chd_precache(cdd.chd.file) != CHDERR_NONE)
-        return -1;
-      log_cb(RETRO_LOG_INFO, "Pre-cache done.\n");
-    }
-#endif
-
     /* retrieve CHD header */
     head = chd_get_header(cdd.chd.file);
 
@@ -431,19 +1114,36 @@ int cdd_load(char *filename, char *header)
       return -1;
     }
 
-    /* allocate hunk buffer */
-    cdd.chd.hunk = (uint8 *)malloc(head->hunkbytes);
-    if (!cdd.chd.hunk)
+    /* initialize hunk size (usually fixed to 8 sectors) */
+    cdd.chd.hunkbytes = head->hunkbytes;
+
+#ifdef __LIBRETRO__
+    if (config.cd_precache)
+    {
+      log_cb(RETRO_LOG_INFO, "Pre-caching \"%s\" ...\n", filename);
+
+      /* decompress all hunks in memory if requested (falls back to hunks cache of compressed file loaded in memory) */
+      if ((config.cd_precache < 2) || !chd_cache_fill(head, filename))
+      {
+        if (config.cd_precache > 1)
+          log_cb(RETRO_LOG_WARN, "Could not decompress \"%s\" in memory.\n", filename);
+        if (chd_precache(cdd.chd.file) != CHDERR_NONE)
+          return -1;
+      }
+      log_cb(RETRO_LOG_INFO, "Pre-cache done.\n");
+    }
+#endif
+
+    /* allocate decompressed hunks cache */
+    if (!chd_cache.full && !chd_cache_init(head))
     {
       chd_close(cdd.chd.file);
       cdStreamClose(fd);
       return -1;
     }
 
-    /* initialize hunk size (usually fixed to 8 sectors) */
-    cdd.chd.hunkbytes = head->hunkbytes;
-
     /* initialize buffered hunk index */
+    cdd.chd.hunk = NULL;
     cdd.chd.hunknum = -1;
 
     /* retrieve tracks informations */
@@ -540,7 +1240,7 @@ int cdd_load(char *filename, char *header)
     {
       /* read first chunk of data */
       cdd.chd.hunknum = cdd.toc.tracks[0].offset / cdd.chd.hunkbytes;
-      chd_read(cdd.chd.file, cdd.chd.hunknum, cdd.chd.hunk);
+      cdd.chd.hunk = chd_cache_read(cdd.chd.hunknum);
 
       /* copy CD image header + security code (skip RAW sector 16-byte header) */
       memcpy(header, cdd.chd.hunk + (cdd.toc.tracks[0].offset % cdd.chd.hunkbytes) + ((cdd.sectorSize == 2048) ? 0 : 16), 0x210);
@@ -558,6 +1258,7 @@ int cdd_load(char *filename, char *header)
     }
 
     /* invalid CHD file */
+    chd_cache_shutdown();
     chd_close(cdd.chd.file);
     cdStreamClose(fd);
     return -1;
@@ -1295,9 +1996,14 @@ void cdd_unload(void)
     int i;
 
 #if defined(USE_LIBCHDR)
+    chd_cache_shutdown();
     chd_close(cdd.chd.file);
-    if (cdd.chd.hunk)
-      free(cdd.chd.hunk);
+    cdd.chd.hunk = NULL;
+#endif
+
+#if (defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)) && defined(USE_THREADS)
+    /* stop VORBIS decoder thread */
+    ogg_stream_shutdown();
 #endif
 
     /* close CD tracks */
@@ -1364,7 +2070,7 @@ void cdd_read_data(uint8 *dst, uint8 *subheader)
       /* update CHD hunk cache if necessary */
       if (hunknum != cdd.chd.hunknum)
       {
-        chd_read(cdd.chd.file, hunknum, cdd.chd.hunk);
+        cdd.chd.hunk = chd_cache_read(hunknum);
         cdd.chd.hunknum = hunknum;
       }
 
@@ -1432,6 +2138,11 @@ void cdd_seek_audio(int index, int lba)
   /* check if track index has changed */
   if (index != cdd.index)
   {
+#ifdef USE_THREADS
+    /* make sure decoder thread is not accessing VORBIS files */
+    ogg_stream_stop();
+#endif
+
     /* close previous track VORBIS file structure to save memory */
     if (cdd.toc.tracks[cdd.index].vf.datasource)
     {
@@ -1453,6 +2164,9 @@ void cdd_seek_audio(int index, int lba)
   {
     /* CHD file offset */
     cdd.chd.hunkofs = cdd.toc.tracks[index].offset + (lba * CD_FRAME_SIZE);
+
+    /* start decompressing target hunk while drive is seeking */
+    chd_cache_prefetch(cdd.chd.hunkofs);
   }
   else
 #endif
@@ -1460,6 +2174,10 @@ void cdd_seek_audio(int index, int lba)
   if (cdd.toc.tracks[index].vf.seekable)
   {
     /* VORBIS AUDIO track */
+#ifdef USE_THREADS
+    /* seek is done asynchronously by decoder thread */
+    if (!ogg_stream_seek(index, (lba * 588) - cdd.toc.tracks[index].offset))
+#endif
     ov_pcm_seek(&cdd.toc.tracks[index].vf, (lba * 588) - cdd.toc.tracks[index].offset);
   }
   else
@@ -1471,16 +2189,93 @@ void cdd_seek_audio(int index, int lba)
   }
 }
 
+/* CD-DA samples are mixed by blocks (output amplitudes computed first, then blip buffer updated) */
+#define CDD_MIX_BLOCK 256
+
+#if defined(USE_LIBCHDR)
+static int16 cdd_mix_in[CDD_MIX_BLOCK * 2];
+#endif
+static int cdd_mix_out[CDD_MIX_BLOCK * 2];
+
+/* mix 16-bit (host-endian) stereo samples, returns number of processed samples (less than count if audio got muted) */
+static int cdd_mix_audio(const int16 *src, int count, int time, int *curVol, int endVol, int *prev)
+{
+  int j, n, mul, done = 0;
+  int vol = *curVol;
+  int volume = config.cdda_volume;
+
+  while (done < count)
+  {
+    n = count - done;
+    if (n > CDD_MIX_BLOCK)
+    {
+      n = CDD_MIX_BLOCK;
+    }
+
+    if (vol == endVol)
+    {
+      /* audio will remain muted until next setup (last sample is still processed) */
+      if (!vol)
+      {
+        n = 1;
+        count = done + 1;
+      }
+
+      /* CD-DA fader multiplier (cf. LC7883 datasheet) */
+      /* (MIN) 0,1,2,3,4,8,12,16,20...,1020,1024 (MAX) */
+      mul = (vol & 0x7fc) ? (vol & 0x7fc) : (vol & 0x03);
+
+      /* constant volume: left & right channels are processed the same way */
+      for (j=0; j<n*2; j++)
+      {
+        cdd_mix_out[j] = (((src[j] * mul) / 1024) * volume) / 100;
+      }
+    }
+    else
+    {
+      /* fade-in or fade-out (one step/sample) */
+      int step = (endVol > vol) ? 1 : -1;
+      if (n > ((endVol - vol) * step))
+      {
+        n = (endVol - vol) * step;
+      }
+
+      for (j=0; j<n; j++)
+      {
+        int v = vol + (j * step);
+        mul = (v & 0x7fc) ? (v & 0x7fc) : (v & 0x03);
+        cdd_mix_out[j*2]   = (((src[j*2]   * mul) / 1024) * volume) / 100;
+        cdd_mix_out[j*2+1] = (((src[j*2+1] * mul) / 1024) * volume) / 100;
+      }
+
+      vol += n * step;
+    }
+
+    /* update blip buffer (unchanged output is skipped) */
+    blip_add_samples(snd.blips[2], time + done, cdd_mix_out, n, prev);
+
+    src += n * 2;
+    done += n;
+  }
+
+  *curVol = vol;
+  return done;
+}
+
 void cdd_read_audio(unsigned int samples)
 {
   /* previous audio outputs */
-  int prev_l = cdd.audio[0];
-  int prev_r = cdd.audio[1];
+  int prev[2];
+  prev[0] = cdd.audio[0];
+  prev[1] = cdd.audio[1];
 
   /* audio track playing ? */
   if (!scd.regs[0x36>>1].byte.h && cdd.toc.tracks[cdd.index].fd)
   {
-    int i, mul, l, r;
+    int i, len;
+#if defined(USE_LIBCHDR) && defined(LSB_FIRST)
+    int j;
+#endif
 
     /* current CD-DA fader volume */
     int curVol = cdd.fader[0];
@@ -1524,80 +2319,57 @@ void cdd_read_audio(unsigned int samples)
 #if defined(USE_LIBCHDR)
     if (cdd.chd.file)
     {
-#ifndef LSB_FIRST
-      int16 *ptr = (int16 *) (cdd.chd.hunk + (cdd.chd.hunkofs % cdd.chd.hunkbytes));
-#else
-      uint8 *ptr = cdd.chd.hunk + (cdd.chd.hunkofs % cdd.chd.hunkbytes);
-#endif
-
       /* process 16-bit (big-endian) stereo samples */
-      for (i=0; i<samples; i++)
+      for (i=0; i<samples; i+=len)
       {
+        uint8 *ptr;
+
         /* CHD hunk index */
         int hunknum = cdd.chd.hunkofs / cdd.chd.hunkbytes;
 
+        /* remaining samples in current sector */
+        int n = (CD_MAX_SECTOR_DATA - (cdd.chd.hunkofs % CD_FRAME_SIZE)) / 4;
+        if (n > (samples - i))
+        {
+          n = samples - i;
+        }
+        if (n > CDD_MIX_BLOCK)
+        {
+          n = CDD_MIX_BLOCK;
+        }
+
         /* update CHD hunk cache if necessary */
         if (hunknum != cdd.chd.hunknum)
         {
-          chd_read(cdd.chd.file, hunknum, cdd.chd.hunk);
+          cdd.chd.hunk = chd_cache_read(hunknum);
           cdd.chd.hunknum = hunknum;
         }
 
-        /* CD-DA fader multiplier (cf. LC7883 datasheet) */
-        /* (MIN) 0,1,2,3,4,8,12,16,20...,1020,1024 (MAX) */
-        mul = (curVol & 0x7fc) ? (curVol & 0x7fc) : (curVol & 0x03);
-
-        /* left & right channels */
+        ptr = cdd.chd.hunk + (cdd.chd.hunkofs % cdd.chd.hunkbytes);
 #ifndef LSB_FIRST
-        l = ((ptr[0] * mul) / 1024);
-        r = ((ptr[1] * mul) / 1024);
-        ptr+=2;
+        memcpy(cdd_mix_in, ptr, n * 4);
 #else
-        l = (((int16)((ptr[1] + ptr[0]*256)) * mul) / 1024);
-        r = (((int16)((ptr[3] + ptr[2]*256)) * mul) / 1024);
-        ptr+=4;
+        for (j=0; j<n*2; j++)
+        {
+          cdd_mix_in[j] = (int16)((ptr[j*2] << 8) | ptr[j*2+1]);
+        }
 #endif
 
-        /* CD-DA output mixing volume (0-100%) */
-        l = (l * config.cdda_volume) / 100;
-        r = (r * config.cdda_volume) / 100;
-
-        /* update blip buffer */
-        blip_add_delta_fast(snd.blips[2], i, l-prev_l, r-prev_r);
-        prev_l = l;
-        prev_r = r;
+        len = cdd_mix_audio(cdd_mix_in, n, i, &curVol, endVol, prev);
 
         /* update CHD file offset */
-        cdd.chd.hunkofs += 4;
+        cdd.chd.hunkofs += len * 4;
 
         /* detect end of sector data (2352 bytes) */
         if ((cdd.chd.hunkofs % CD_FRAME_SIZE) == CD_MAX_SECTOR_DATA)
         {
           /* skip subcode data (96 bytes) */
           cdd.chd.hunkofs += CD_MAX_SUBCODE_DATA;
-
-          /* reinitialize hunk cache pointer */
-#ifndef LSB_FIRST
-          ptr = (int16 *) (cdd.chd.hunk + (cdd.chd.hunkofs % cdd.chd.hunkbytes));
-#else
-          ptr = cdd.chd.hunk + (cdd.chd.hunkofs % cdd.chd.hunkbytes);
-#endif
         }
 
-        /* update CD-DA fader volume (one step/sample) */
-        if (curVol < endVol)
-        {
-          /* fade-in */
-          curVol++;
-        }
-        else if (curVol > endVol)
+        /* audio will remain muted until next setup */
+        if (len < n)
         {
-          /* fade-out */
-          curVol--;
-        }
-        else if (!curVol)
-        {
-          /* audio will remain muted until next setup */
           break;
         }
       }
@@ -1607,9 +2379,18 @@ void cdd_read_audio(unsigned int samples)
 #if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
     if (cdd.toc.tracks[cdd.index].vf.datasource)
     {
-      int len, done = 0;
-      int16 *ptr = (int16 *) (cdc.ram);
+      int done = 0;
       samples = samples * 4;
+#ifdef USE_THREADS
+      /* make sure decoder thread is running for current track */
+      if ((ogg_stream.started && (ogg_stream.track == cdd.index)) ||
+          ogg_stream_seek(cdd.index, ov_pcm_tell(&cdd.toc.tracks[cdd.index].vf)))
+      {
+        /* read decoded samples (end of file is handled the same way as below) */
+        ogg_stream_read(cdc.ram, samples);
+        done = samples;
+      }
+#endif
       while (done < samples)
       {
 #ifdef USE_LIBVORBIS
@@ -1627,114 +2408,47 @@ void cdd_read_audio(unsigned int samples)
       samples = done / 4;
 
       /* process 16-bit (host-endian) stereo samples */
-      for (i=0; i<samples; i++)
-      {
-        /* CD-DA fader multiplier (cf. LC7883 datasheet) */
-        /* (MIN) 0,1,2,3,4,8,12,16,20...,1020,1024 (MAX) */
-        mul = (curVol & 0x7fc) ? (curVol & 0x7fc) : (curVol & 0x03);
-
-        /* left & right channels */
-        l = ((ptr[0] * mul) / 1024);
-        r = ((ptr[1] * mul) / 1024);
-
-        /* CD-DA output mixing volume (0-100%) */
-        l = (l * config.cdda_volume) / 100;
-        r = (r * config.cdda_volume) / 100;
-
-        /* update blip buffer */
-        blip_add_delta_fast(snd.blips[2], i, l-prev_l, r-prev_r);
-        prev_l = l;
-        prev_r = r;
-        ptr+=2;
-
-        /* update CD-DA fader volume (one step/sample) */
-        if (curVol < endVol)
-        {
-          /* fade-in */
-          curVol++;
-        }
-        else if (curVol > endVol)
-        {
-          /* fade-out */
-          curVol--;
-        }
-        else if (!curVol)
-        {
-          /* audio will remain muted until next setup */
-          break;
-        }
-      }
+      cdd_mix_audio((int16 *)cdc.ram, samples, 0, &curVol, endVol, prev);
     }
     else
 #endif
     {
-#ifdef LSB_FIRST
-      int16 *ptr = (int16 *) (cdc.ram);
-#else
-      uint8 *ptr = cdc.ram;
-#endif
-      cdStreamRead(cdc.ram, 1, samples * 4, cdd.toc.tracks[cdd.index].fd);
-
-      /* process 16-bit (little-endian) stereo samples */
-      for (i=0; i<samples; i++)
+      /* CD-DA fader muted and output already silent ? */
+      if (!curVol && !endVol && !(prev[0] | prev[1]))
       {
-        /* CD-DA fader multiplier (cf. LC7883 datasheet) */
-        /* (MIN) 0,1,2,3,4,8,12,16,20...,1020,1024 (MAX) */
-        mul = (curVol & 0x7fc) ? (curVol & 0x7fc) : (curVol & 0x03);
-
-        /* left & right channels */
-#ifdef LSB_FIRST
-        l = ((ptr[0] * mul) / 1024);
-        r = ((ptr[1] * mul) / 1024);
-        ptr+=2;
-#else
-        l = (((int16)((ptr[0] + ptr[1]*256)) * mul) / 1024);
-        r = (((int16)((ptr[2] + ptr[3]*256)) * mul) / 1024);
-        ptr+=4;
-#endif
-
-        /* CD-DA output mixing volume (0-100%) */
-        l = (l * config.cdda_volume) / 100;
-        r = (r * config.cdda_volume) / 100;
-
-        /* update blip buffer */
-        blip_add_delta_fast(snd.blips[2], i, l-prev_l, r-prev_r);
-        prev_l = l;
-        prev_r = r;
-
-        /* update CD-DA fader volume (one step/sample) */
-        if (curVol < endVol)
-        {
-          /* fade-in */
-          curVol++;
-        }
-        else if (curVol > endVol)
-        {
-          /* fade-out */
-          curVol--;
-        }
-        else if (!curVol)
+        /* skip samples without reading them (only first sample is processed) */
+        cdStreamSeek(cdd.toc.tracks[cdd.index].fd, samples * 4, SEEK_CUR);
+      }
+      else
+      {
+        cdStreamRead(cdc.ram, 1, samples * 4, cdd.toc.tracks[cdd.index].fd);
+#ifndef LSB_FIRST
+        /* convert 16-bit (little-endian) stereo samples */
+        for (i=0; i<samples*2; i++)
         {
-          /* audio will remain muted until next setup */
-          break;
+          ((int16 *)cdc.ram)[i] = (int16)(cdc.ram[i*2] | (cdc.ram[i*2+1] << 8));
         }
+#endif
       }
+
+      /* process 16-bit (host-endian) stereo samples */
+      cdd_mix_audio((int16 *)cdc.ram, samples, 0, &curVol, endVol, prev);
     }
 
     /* save current CD-DA fader volume */
     cdd.fader[0] = curVol;
 
     /* save last audio output for next frame */
-    cdd.audio[0] = prev_l;
-    cdd.audio[1] = prev_r;
+    cdd.audio[0] = prev[0];
+    cdd.audio[1] = prev[1];
   }
   else
   {
     /* no audio output */
-    if (prev_l | prev_r)
+    if (prev[0] | prev[1])
     {
       /* update blip buffer */
-      blip_add_delta_fast(snd.blips[2], 0, -prev_l, -prev_r);
+      blip_add_delta_fast(snd.blips[2], 0, -prev[0], -prev[1]);
 
       /* save audio output for next frame */
       cdd.audio[0] = 0;
@@ -2016,6 +2730,13 @@ void cdd_update(void)
       /* seek to current track sector */
       cdd_seek_audio(index, lba);
     }
+#if defined(USE_LIBCHDR)
+    else if (cdd.chd.file && (lba >= 0))
+    {
+      /* start decompressing target data hunk while drive is seeking */
+      chd_cache_prefetch(cdd.toc.tracks[0].offset + (lba * CD_FRAME_SIZE));
+    }
+#endif
 
     /* update current track index */
     cdd.index = index;
@@ -36,6 +36,35 @@
  *
  ****************************************************************************************/
 #include "shared.h"
+#include "mthread.h"
+
+#ifdef USE_THREADS
+/* Maximal number of threads rendering image buffer lines (including emulation thread) */
+#define GFX_MAX_THREADS 4
+
+/* Minimal number of lines before rendering is shared between threads */
+#define GFX_MIN_LINES 8
+
+static struct
+{
+  mt_thread_t thread[GFX_MAX_THREADS - 1];
+  mt_mutex_t lock;
+  mt_cond_t start;
+  mt_cond_t done;
+  int workers;                    /* number of started worker threads */
+  int threads;                    /* number of threads rendering current job */
+  int pending;                    /* number of workers still rendering current job */
+  uint32 job;                     /* current job index */
+  int quit;
+  uint32 lines;                   /* number of lines to render */
+  uint32 width;                   /* line width (dots) */
+  uint32 bufferStart[256];        /* image buffer start index for each line */
+  uint16 *tracePtr[256];          /* trace vector pointer for each line */
+  uint8 overlap[256];             /* set if line reads an image buffer cell row written by rendered lines */
+  uint8 written[0x40000 >> 5];    /* image buffer cell rows (4 bytes) written by rendered lines */
+  uint8 pixels[256][0x200];       /* stamp pixels fetched for each line */
+} gfx_pool;
+#endif
 
 /***************************************************************/
 /*          WORD-RAM DMA interfaces (1M & 2M modes)            */
@@ -465,140 +494,470 @@ int gfx_context_load(uint8 *state)
   return bufferptr;
 }
 
-INLINE void gfx_render(uint32 bufferIndex, uint32 width)
+/* Read stamp pixel at current pixel map position, then increment pixel position */
+/* (READ is invoked with the Word-RAM byte address of each stamp map or stamp data read) */
+#define GFX_READ_DOT(PIXEL, READ) \
+  xpos &= pos_mask; \
+  ypos &= pos_mask; \
+  \
+  /* force pixel output to 0 if pixel is outside stamp map */ \
+  PIXEL = 0x00; \
+  \
+  if (!((xpos | ypos) & dot_mask)) \
+  { \
+    /* read stamp map table data */ \
+    map_index = (xpos >> gfx.stampShift) | ((ypos >> gfx.stampShift) << gfx.mapShift); \
+    READ(map_base + (map_index << 1)) \
+    stamp_data = gfx.mapPtr[map_index]; \
+    \
+    /* stamp generator base index                                     */ \
+    /* sss ssssssss ccyyyxxx (16x16) or sss sssssscc ccyyyxxx (32x32) */ \
+    /* with:  s = stamp number (1 stamp = 16x16 or 32x32 pixels)      */ \
+    /*        c = cell offset  (0-3 for 16x16, 0-15 for 32x32)        */ \
+    /*      yyy = line offset  (0-7)                                  */ \
+    /*      xxx = pixel offset (0-7)                                  */ \
+    stamp_index = (stamp_data & stamp_mask) << 8; \
+    \
+    /* stamp 0 is not used: force pixel output to 0 */ \
+    if (stamp_index) \
+    { \
+      /* extract HFLIP & ROTATION bits */ \
+      stamp_data = (stamp_data >> 13) & 7; \
+      \
+      /* cell offset (0-3 or 0-15)                             */ \
+      /* table entry = yyxxshrr (8 bits)                       */ \
+      /* with: yy = cell row  (0-3) = (ypos >> (11 + 3)) & 3   */ \
+      /*       xx = cell column (0-3) = (xpos >> (11 + 3)) & 3 */ \
+      /*        s = stamp size (0=16x16, 1=32x32)              */ \
+      /*      hrr = HFLIP & ROTATION bits                      */ \
+      stamp_index |= gfx.lut_cell[stamp_data | stamp_size | ((ypos >> 8) & 0xc0) | ((xpos >> 10) & 0x30)] << 6; \
+      \
+      /* pixel  offset (0-63)                              */ \
+      /* table entry = yyyxxxhrr (9 bits)                  */ \
+      /* with: yyy = pixel row  (0-7) = (ypos >> 11) & 7   */ \
+      /*       xxx = pixel column (0-7) = (xpos >> 11) & 7 */ \
+      /*       hrr = HFLIP & ROTATION bits                 */ \
+      stamp_index |= gfx.lut_pixel[stamp_data | ((xpos >> 8) & 0x38) | ((ypos >> 5) & 0x1c0)]; \
+      \
+      /* extract left or right pixel from pixel pair (2 pixels/byte) */ \
+      READ(stamp_index >> 1) \
+      PIXEL = (READ_BYTE(scd.word_ram_2M, stamp_index >> 1) >> ((~stamp_index & 1) << 2)) & 0x0f; \
+    } \
+  } \
+  \
+  /* increment pixel position */ \
+  xpos += xoffset; \
+  ypos += yoffset;
+
+/* Check if Word-RAM read address is within image buffer cell row being rendered */
+#define GFX_CHECK_ROW(ADDR) \
+  overlap |= (((ADDR) >> 2) == row);
+#define GFX_NO_CHECK(ADDR)
+
+/* Line rendering parameters (declarations) */
+#define GFX_LINE_PARAMS(TRACE) \
+  /* bits [1:0] of 32x32 pixels stamp index are masked (see Chuck Rock II - Son of Chuck) */ \
+  uint32 stamp_mask = (scd.regs[0x58>>1].byte.l & 0x02) ? 0x7fc : 0x7ff; \
+  \
+  /* stamp size bit for cell offset table index */ \
+  uint32 stamp_size = (scd.regs[0x58>>1].byte.l & 0x02) << 2; \
+  \
+  /* pixel map range (stamp map range if repeated, 24-bit range otherwise) */ \
+  uint32 pos_mask = (scd.regs[0x58>>1].byte.l & 0x01) ? gfx.dotMask : 0xffffff; \
+  \
+  /* pixels outside stamp map */ \
+  uint32 dot_mask = ~gfx.dotMask; \
+  \
+  /* stamp map table Word-RAM address */ \
+  uint32 map_base = (uint8 *)gfx.mapPtr - scd.word_ram_2M; \
+  \
+  /* pixel map start position for current line (13.3 format converted to 13.11) */ \
+  uint32 xpos = (TRACE)[0] << 8; \
+  uint32 ypos = (TRACE)[1] << 8; \
+  \
+  /* pixel map offset values for current line (5.11 format) */ \
+  uint32 xoffset = (int16) (TRACE)[2]; \
+  uint32 yoffset = (int16) (TRACE)[3];
+
+/* Write up to 8 pixels to image buffer cell row (priority mode is applied to each pixel separately so both pixels of a pair are written at once) */
+INLINE void gfx_write_row(uint32 bufferIndex, uint32 count, const uint8 *pixels, uint8 (*lut_prio)[0x100])
 {
-  uint8 pixel_in, pixel_out;
-  uint16 stamp_data;
-  uint32 stamp_index;
-
-  /* bits [1:0] of 32x32 pixels stamp index are masked (see Chuck Rock II - Son of Chuck) */
-  uint32 stamp_mask = (scd.regs[0x58>>1].byte.l & 0x02) ? 0x7fc : 0x7ff;
+  uint8 pixel_in;
+  uint32 i = 0;
 
-  /* pixel map start position for current line (13.3 format converted to 13.11) */
-  uint32 xpos = *gfx.tracePtr++ << 8;
-  uint32 ypos = *gfx.tracePtr++ << 8;
+  /* right pixel only */
+  if (bufferIndex & 1)
+  {
+    pixel_in = READ_BYTE(scd.word_ram_2M, (bufferIndex >> 1) & 0x3ffff);
+    WRITE_BYTE(scd.word_ram_2M, (bufferIndex >> 1) & 0x3ffff, lut_prio[pixel_in][(pixel_in & 0xf0) | pixels[0]]);
+    i = 1;
+  }
 
-  /* pixel map offset values for current line (5.11 format) */
-  uint32 xoffset = (int16) *gfx.tracePtr++;
-  uint32 yoffset = (int16) *gfx.tracePtr++;
+  /* pixel pairs */
+  for (; (i+1)<count; i+=2)
+  {
+    pixel_in = READ_BYTE(scd.word_ram_2M, ((bufferIndex + i) >> 1) & 0x3ffff);
+    WRITE_BYTE(scd.word_ram_2M, ((bufferIndex + i) >> 1) & 0x3ffff, lut_prio[pixel_in][(pixels[i] << 4) | pixels[i+1]]);
+  }
 
-  /* handle trace vector address overflow */
-  if (gfx.tracePtr == (uint16 *)(scd.word_ram_2M + 0x40000))
+  /* left pixel only */
+  if (i < count)
   {
-    gfx.tracePtr = (uint16 *)(scd.word_ram_2M);
+    pixel_in = READ_BYTE(scd.word_ram_2M, ((bufferIndex + i) >> 1) & 0x3ffff);
+    WRITE_BYTE(scd.word_ram_2M, ((bufferIndex + i) >> 1) & 0x3ffff, lut_prio[pixel_in][(pixels[i] << 4) | (pixel_in & 0x0f)]);
+  }
+}
+
+/* Next image buffer cell row */
+#define GFX_NEXT_ROW(INDEX, COUNT) \
+  /* check last pixel position */ \
+  INDEX += (COUNT) - 1; \
+  if ((INDEX & 7) != 7) \
+  { \
+    /* next pixel */ \
+    INDEX++; \
+  } \
+  else \
+  { \
+    /* next cell: increment image buffer offset by one column (minus 7 pixels) */ \
+    INDEX += gfx.bufferOffset; \
   }
 
-  /* process all dots */
-  while (width--)
+INLINE void gfx_render(uint32 bufferIndex, uint32 width, uint16 *tracePtr)
+{
+  uint8 pixels[8];
+  uint8 pixel_in, pixel_out;
+  uint16 stamp_data;
+  uint32 stamp_index, map_index, i, count, row, overlap, row_xpos, row_ypos;
+
+  /* priority mode write table */
+  uint8 (*lut_prio)[0x100] = gfx.lut_prio[(scd.regs[0x02>>1].w >> 3) & 0x03];
+
+  GFX_LINE_PARAMS(tracePtr)
+
+  /* process dots by image buffer cell rows (up to 8 pixels = 4 bytes) */
+  while (width)
   {
-    /* check if stamp map is repeated */
-    if (scd.regs[0x58>>1].byte.l & 0x01)
-    {
-      /* stamp map range */
-      xpos &= gfx.dotMask;
-      ypos &= gfx.dotMask;
-    }
-    else
+    /* remaining dots in current cell row */
+    count = 8 - (bufferIndex & 7);
+    if (count > width)
     {
-      /* 24-bit range */
-      xpos &= 0xffffff;
-      ypos &= 0xffffff;
+      count = width;
     }
 
-    /* check if pixel is outside stamp map */
-    if ((xpos | ypos) & ~gfx.dotMask)
+    /* cell row Word-RAM address (4 bytes aligned) */
+    row = ((bufferIndex >> 1) & 0x3ffff) >> 2;
+    overlap = 0;
+    row_xpos = xpos;
+    row_ypos = ypos;
+
+    /* read stamp pixels */
+    for (i=0; i<count; i++)
     {
-      /* force pixel output to 0 */
-      pixel_out = 0x00;
+      GFX_READ_DOT(pixels[i], GFX_CHECK_ROW)
     }
-    else
+
+    if (overlap)
     {
-      /* read stamp map table data */
-      stamp_data = gfx.mapPtr[(xpos >> gfx.stampShift) | ((ypos >> gfx.stampShift) << gfx.mapShift)];
-
-      /* stamp generator base index                                     */
-      /* sss ssssssss ccyyyxxx (16x16) or sss sssssscc ccyyyxxx (32x32) */
-      /* with:  s = stamp number (1 stamp = 16x16 or 32x32 pixels)      */
-      /*        c = cell offset  (0-3 for 16x16, 0-15 for 32x32)        */
-      /*      yyy = line offset  (0-7)                                  */
-      /*      xxx = pixel offset (0-7)                                  */
-      stamp_index = (stamp_data & stamp_mask) << 8;
-
-      if (stamp_index)
+      /* stamp map or stamp data is read from cell row being rendered: process dots one by one */
+      /* so that each dot sees previous dots already written (same as original rendering order) */
+      xpos = row_xpos;
+      ypos = row_ypos;
+
+      for (i=0; i<count; i++)
       {
-        /* extract HFLIP & ROTATION bits */
-        stamp_data = (stamp_data >> 13) & 7;
-
-        /* cell offset (0-3 or 0-15)                             */
-        /* table entry = yyxxshrr (8 bits)                       */
-        /* with: yy = cell row  (0-3) = (ypos >> (11 + 3)) & 3   */
-        /*       xx = cell column (0-3) = (xpos >> (11 + 3)) & 3 */
-        /*        s = stamp size (0=16x16, 1=32x32)              */
-        /*      hrr = HFLIP & ROTATION bits                      */
-        stamp_index |= gfx.lut_cell[stamp_data | ((scd.regs[0x58>>1].byte.l & 0x02) << 2 ) | ((ypos >> 8) & 0xc0) | ((xpos >> 10) & 0x30)] << 6;
-            
-        /* pixel  offset (0-63)                              */
-        /* table entry = yyyxxxhrr (9 bits)                  */
-        /* with: yyy = pixel row  (0-7) = (ypos >> 11) & 7   */
-        /*       xxx = pixel column (0-7) = (xpos >> 11) & 7 */
-        /*       hrr = HFLIP & ROTATION bits                 */
-        stamp_index |= gfx.lut_pixel[stamp_data | ((xpos >> 8) & 0x38) | ((ypos >> 5) & 0x1c0)];
-
-        /* read pixel pair (2 pixels/byte) */
-        pixel_out = READ_BYTE(scd.word_ram_2M, stamp_index >> 1);
-
-        /* extract left or rigth pixel */
-        if (stamp_index & 1)
+        GFX_READ_DOT(pixel_out, GFX_NO_CHECK)
+
+        /* read out paired pixel data */
+        pixel_in = READ_BYTE(scd.word_ram_2M, ((bufferIndex + i) >> 1) & 0x3ffff);
+
+        /* update left or right pixel */
+        if ((bufferIndex + i) & 1)
         {
-           pixel_out &= 0x0f;
+          pixel_out |= (pixel_in & 0xf0);
         }
         else
         {
-           pixel_out >>= 4;
+          pixel_out = (pixel_out << 4) | (pixel_in & 0x0f);
         }
+
+        /* priority mode write */
+        WRITE_BYTE(scd.word_ram_2M, ((bufferIndex + i) >> 1) & 0x3ffff, lut_prio[pixel_in][pixel_out]);
       }
-      else
+    }
+    else
+    {
+      /* write pixels to image buffer */
+      gfx_write_row(bufferIndex, count, pixels, lut_prio);
+    }
+
+    GFX_NEXT_ROW(bufferIndex, count)
+
+    width -= count;
+  }
+}
+
+#ifdef USE_THREADS
+/* Word-RAM cell row written by rendered lines */
+#define GFX_WRITTEN(ADDR) (gfx_pool.written[(ADDR) >> 5] & (1 << (((ADDR) >> 2) & 7)))
+
+/* Check Word-RAM addresses read while fetching stamp pixels */
+#define GFX_CHECK_READ(ADDR) overlap |= GFX_WRITTEN(ADDR);
+
+/* fetch stamp pixels of one line (Word-RAM is not modified) */
+static void gfx_fetch_line(uint32 line)
+{
+  uint8 *pixels = gfx_pool.pixels[line];
+  uint16 stamp_data;
+  uint32 stamp_index, map_index, i;
+  uint32 overlap = 0;
+
+  GFX_LINE_PARAMS(gfx_pool.tracePtr[line])
+
+  for (i=0; i<gfx_pool.width; i++)
+  {
+    GFX_READ_DOT(pixels[i], GFX_CHECK_READ)
+  }
+
+  gfx_pool.overlap[line] = overlap ? 1 : 0;
+}
+
+static void gfx_fetch_lines(int index, int count)
+{
+  uint32 line;
+
+  /* lines are interleaved between threads */
+  for (line = index; line < gfx_pool.lines; line += count)
+  {
+    gfx_fetch_line(line);
+  }
+}
+
+static void gfx_worker(void *arg)
+{
+  int index = (int)(size_t)arg;
+  uint32 job = 0;
+
+  mt_mutex_lock(&gfx_pool.lock);
+
+  while (1)
+  {
+    /* wait for next job */
+    while (!gfx_pool.quit && (gfx_pool.job == job))
+    {
+      mt_cond_wait(&gfx_pool.start, &gfx_pool.lock);
+    }
+
+    if (gfx_pool.quit)
+    {
+      break;
+    }
+
+    job = gfx_pool.job;
+
+    mt_mutex_unlock(&gfx_pool.lock);
+    gfx_fetch_lines(index, gfx_pool.threads);
+    mt_mutex_lock(&gfx_pool.lock);
+
+    if (--gfx_pool.pending == 0)
+    {
+      mt_cond_signal(&gfx_pool.done);
+    }
+  }
+
+  mt_mutex_unlock(&gfx_pool.lock);
+}
+
+static int gfx_pool_init(void)
+{
+  int i, count = mt_cpu_count();
+
+  if (count > GFX_MAX_THREADS)
+  {
+    count = GFX_MAX_THREADS;
+  }
+
+  /* single core: rendering is done on emulation thread */
+  if (count < 2)
+  {
+    gfx_pool.workers = -1;
+    return 0;
+  }
+
+  mt_mutex_init(&gfx_pool.lock);
+  mt_cond_init(&gfx_pool.start);
+  mt_cond_init(&gfx_pool.done);
+  gfx_pool.job = 0;
+  gfx_pool.quit = 0;
+
+  for (i=0; i<(count-1); i++)
+  {
+    if (!mt_thread_create(&gfx_pool.thread[i], gfx_worker, (void *)(size_t)(i + 1)))
+    {
+      break;
+    }
+  }
+
+  /* no worker thread could be started */
+  if (!i)
+  {
+    mt_cond_destroy(&gfx_pool.done);
+    mt_cond_destroy(&gfx_pool.start);
+    mt_mutex_destroy(&gfx_pool.lock);
+    gfx_pool.workers = -1;
+    return 0;
+  }
+
+  gfx_pool.workers = i;
+  return i;
+}
+
+/* render lines using worker threads, returns only once all lines have been rendered */
+/* stamp pixels are fetched by all threads then written to image buffer in line order, */
+/* which is only done if lines do not read Word-RAM written by any rendered line       */
+static void gfx_render_parallel(uint32 lines)
+{
+  uint32 line, index, width, count, addr;
+  uint32 overlap = 0;
+  uint8 (*lut_prio)[0x100] = gfx.lut_prio[(scd.regs[0x02>>1].w >> 3) & 0x03];
+
+  memset(gfx_pool.written, 0, sizeof(gfx_pool.written));
+
+  gfx_pool.lines = lines;
+  gfx_pool.width = scd.regs[0x62>>1].w & 0x1ff;
+
+  /* precalculate each line start parameters */
+  for (line = 0; line < lines; line++)
+  {
+    gfx_pool.tracePtr[line] = gfx.tracePtr;
+    gfx_pool.bufferStart[line] = gfx.bufferStart;
+
+    /* image buffer cell rows written by this line */
+    index = gfx.bufferStart;
+    width = gfx_pool.width;
+    while (width)
+    {
+      count = 8 - (index & 7);
+      if (count > width)
       {
-        /* stamp 0 is not used: force pixel output to 0 */
-        pixel_out = 0x00;
+        count = width;
       }
+
+      addr = (index >> 1) & 0x3ffff;
+      gfx_pool.written[addr >> 5] |= 1 << ((addr >> 2) & 7);
+
+      GFX_NEXT_ROW(index, count)
+
+      width -= count;
     }
 
-    /* read out paired pixel data */
-    pixel_in = READ_BYTE(scd.word_ram_2M, (bufferIndex >> 1) & 0x3ffff);
+    /* handle trace vector address overflow */
+    gfx.tracePtr += 4;
+    if (gfx.tracePtr == (uint16 *)(scd.word_ram_2M + 0x40000))
+    {
+      gfx.tracePtr = (uint16 *)(scd.word_ram_2M);
+    }
+
+    /* increment image buffer start index for next line (8 pixels/line) */
+    gfx.bufferStart += 8;
+  }
+
+  /* trace vectors (8 bytes, two cell rows) read by rendered lines */
+  for (line = 0; line < lines; line++)
+  {
+    addr = (uint8 *)gfx_pool.tracePtr[line] - scd.word_ram_2M;
+    overlap |= GFX_WRITTEN(addr) | GFX_WRITTEN(addr + 4);
+  }
 
-    /* update left or rigth pixel */
-    if (bufferIndex & 1)
+  /* trace vectors are not modified by rendered lines */
+  if (!overlap)
+  {
+    /* start workers */
+    mt_mutex_lock(&gfx_pool.lock);
+    gfx_pool.threads = gfx_pool.workers + 1;
+    gfx_pool.pending = gfx_pool.workers;
+    gfx_pool.job++;
+    mt_cond_broadcast(&gfx_pool.start);
+    mt_mutex_unlock(&gfx_pool.lock);
+
+    /* emulation thread fetches its own lines */
+    gfx_fetch_lines(0, gfx_pool.threads);
+
+    /* wait for all lines to be fetched */
+    mt_mutex_lock(&gfx_pool.lock);
+    while (gfx_pool.pending)
     {
-      pixel_out |= (pixel_in & 0xf0);
+      mt_cond_wait(&gfx_pool.done, &gfx_pool.lock);
     }
-    else
+    mt_mutex_unlock(&gfx_pool.lock);
+
+    /* stamp map and stamp data read by all lines */
+    for (line = 0; line < lines; line++)
     {
-      pixel_out = (pixel_out << 4) | (pixel_in & 0x0f);
+      overlap |= gfx_pool.overlap[line];
     }
 
-    /* priority mode write */
-    pixel_out = gfx.lut_prio[(scd.regs[0x02>>1].w >> 3) & 0x03][pixel_in][pixel_out];
+    /* fetched pixels are valid if no line reads Word-RAM written by rendered lines */
+    if (!overlap)
+    {
+      /* write lines to image buffer */
+      for (line = 0; line < lines; line++)
+      {
+        index = gfx_pool.bufferStart[line];
+        width = gfx_pool.width;
 
-    /* write data to image buffer */
-    WRITE_BYTE(scd.word_ram_2M, (bufferIndex >> 1) & 0x3ffff, pixel_out);
+        while (width)
+        {
+          count = 8 - (index & 7);
+          if (count > width)
+          {
+            count = width;
+          }
 
-    /* check current pixel position  */
-    if ((bufferIndex & 7) != 7)
-    {
-      /* next pixel */
-      bufferIndex++;
+          gfx_write_row(index, count, &gfx_pool.pixels[line][gfx_pool.width - width], lut_prio);
+
+          GFX_NEXT_ROW(index, count)
+
+          width -= count;
+        }
+      }
+
+      return;
     }
-    else
+  }
+
+  /* rendered lines overlap stamp map, stamp data or trace vectors: render lines one by one */
+  for (line = 0; line < lines; line++)
+  {
+    gfx_render(gfx_pool.bufferStart[line], gfx_pool.width, gfx_pool.tracePtr[line]);
+  }
+}
+#endif
+
+void gfx_shutdown(void)
+{
+#ifdef USE_THREADS
+  int i;
+
+  if (gfx_pool.workers > 0)
+  {
+    mt_mutex_lock(&gfx_pool.lock);
+    gfx_pool.quit = 1;
+    mt_cond_broadcast(&gfx_pool.start);
+    mt_mutex_unlock(&gfx_pool.lock);
+
+    for (i=0; i<gfx_pool.workers; i++)
     {
-      /* next cell: increment image buffer offset by one column (minus 7 pixels) */
-      bufferIndex += gfx.bufferOffset;
+      mt_thread_join(gfx_pool.thread[i]);
     }
 
-    /* increment pixel position */
-    xpos += xoffset;
-    ypos += yoffset;
+    mt_cond_destroy(&gfx_pool.done);
+    mt_cond_destroy(&gfx_pool.start);
+    mt_mutex_destroy(&gfx_pool.lock);
   }
+
+  gfx_pool.workers = 0;
+#endif
 }
 
 void gfx_start(unsigned int base, int cycles)
@@ -735,11 +1094,30 @@ void gfx_update(int cycles)
         }
       }
 
+#ifdef USE_THREADS
+      /* render lines using multiple threads (if enabled) */
+      if (config.gfx_threads && (lines >= GFX_MIN_LINES) && (gfx_pool.workers >= 0))
+      {
+        if (gfx_pool.workers || gfx_pool_init())
+        {
+          gfx_render_parallel(lines);
+          return;
+        }
+      }
+#endif
+
       /* render lines */
       while (lines--)
       {
         /* process dots to image buffer */
-        gfx_render(gfx.bufferStart, scd.regs[0x62>>1].w & 0x1ff);
+        gfx_render(gfx.bufferStart, scd.regs[0x62>>1].w & 0x1ff, gfx.tracePtr);
+
+        /* handle trace vector address overflow */
+        gfx.tracePtr += 4;
+        if (gfx.tracePtr == (uint16 *)(scd.word_ram_2M + 0x40000))
+        {
+          gfx.tracePtr = (uint16 *)(scd.word_ram_2M);
+        }
 
         /* increment image buffer start index for next line (8 pixels/line) */
         gfx.bufferStart += 8;
@@ -112,5 +112,6 @@ extern int gfx_context_save(uint8 *state);
 extern int gfx_context_load(uint8 *state);
 extern void gfx_start(unsigned int base, int cycles);
 extern void gfx_update(int cycles);
+extern void gfx_shutdown(void);
 
 #endif
@@ -46,11 +46,31 @@ extern int8 reset_do_not_clear_buffers;
 
 #define pcm scd.pcm_hw
 
+/* PCM samples are generated by blocks, one channel at a time */
+#define PCM_BLOCK_SIZE 256
+
+/* signed PCM data lookup table (loop data outputs nothing) */
+static int pcm_lut[0x100];
+
+/* mixed L/R outputs of current block */
+static int pcm_mix[PCM_BLOCK_SIZE * 2];
+
 void pcm_init(double clock, int samplerate)
 {
+  int i;
+
   /* PCM chip is running at original rate and is synchronized with SUB-CPU  */
   /* Chip output is resampled to desired rate using Blip Buffer. */
   blip_set_rates(snd.blips[1], clock / PCM_SCYCLES_RATIO, samplerate);
+
+  /* PCM data bit 7 is sign bit (output centered around 0) */
+  for (i=0; i<0xff; i++)
+  {
+    pcm_lut[i] = (i & 0x80) ? (i & 0x7f) : -(i & 0x7f);
+  }
+
+  /* infinite loop should not output any data */
+  pcm_lut[0xff] = 0;
 }
 
 void pcm_reset(void)
@@ -175,16 +195,26 @@ void pcm_run(unsigned int length)
     return;
   }
 
-  /* check if PCM chip is running */
-  if (pcm.enabled)
+  /* check if PCM chip is running with at least one channel enabled */
+  if (pcm.enabled && pcm.status)
   {
-    int i, j, l, r;
-  
-    /* generate PCM samples */
-    for (i=0; i<length; i++)
+    int i, j, n, time;
+    int prev[2];
+
+    prev[0] = prev_l;
+    prev[1] = prev_r;
+
+    /* generate PCM samples by blocks */
+    for (time=0; time<length; time+=n)
     {
-      /* clear output */
-      l = r = 0;
+      n = length - time;
+      if (n > PCM_BLOCK_SIZE)
+      {
+        n = PCM_BLOCK_SIZE;
+      }
+
+      /* clear outputs */
+      memset(pcm_mix, 0, n * 2 * sizeof(int));
 
       /* run eight PCM channels */
       for (j=0; j<8; j++)
@@ -192,69 +222,82 @@ void pcm_run(unsigned int length)
         /* check if channel is enabled */
         if (pcm.status & (1 << j))
         {
-          /* read from current WAVE RAM address */
-          short data = pcm.ram[(pcm.chan[j].addr >> 11) & 0xffff];
+          uint32 addr = pcm.chan[j].addr;
+          uint32 fd = pcm.chan[j].fd.w;
+          uint32 ls = pcm.chan[j].ls.w;
 
-          /* loop data ? */
-          if (data == 0xff)
-          {
-            /* reset WAVE RAM address */
-            pcm.chan[j].addr = pcm.chan[j].ls.w << 11;
-
-            /* read again from WAVE RAM address */
-            data = pcm.ram[pcm.chan[j].ls.w];
-          }
-          else
-          {
-            /* increment WAVE RAM address */
-            pcm.chan[j].addr += pcm.chan[j].fd.w;
-          }
+          /* ENV & stereo PAN multipliers */
+          int mul_l = pcm.chan[j].env * (pcm.chan[j].pan & 0x0F);
+          int mul_r = pcm.chan[j].env * (pcm.chan[j].pan >> 4);
 
-          /* infinite loop should not output any data */
-          if (data != 0xff)
+          if (mul_l | mul_r)
           {
-            /* check sign bit (output centered around 0) */
-            if (data & 0x80)
+            for (i=0; i<n; i++)
             {
-              /* PCM data is positive */
-              data = data & 0x7f;
+              /* read from current WAVE RAM address */
+              int data = pcm.ram[(addr >> 11) & 0xffff];
+
+              /* loop data ? */
+              if (data == 0xff)
+              {
+                /* reset WAVE RAM address */
+                addr = ls << 11;
+
+                /* read again from WAVE RAM address */
+                data = pcm.ram[ls];
+              }
+              else
+              {
+                /* increment WAVE RAM address */
+                addr += fd;
+              }
+
+              /* multiply PCM data with ENV & stereo PAN data then add to L/R outputs (14.5 fixed point) */
+              data = pcm_lut[data];
+              pcm_mix[i*2]   += ((data * mul_l) >> 5);
+              pcm_mix[i*2+1] += ((data * mul_r) >> 5);
             }
-            else
+          }
+          else
+          {
+            /* muted channel: only update WAVE RAM address */
+            for (i=0; i<n; i++)
             {
-              /* PCM data is negative */
-              data = -(data & 0x7f);
+              if (pcm.ram[(addr >> 11) & 0xffff] == 0xff)
+              {
+                addr = ls << 11;
+              }
+              else
+              {
+                addr += fd;
+              }
             }
-
-            /* multiply PCM data with ENV & stereo PAN data then add to L/R outputs (14.5 fixed point) */
-            l += ((data * pcm.chan[j].env * (pcm.chan[j].pan & 0x0F)) >> 5);
-            r += ((data * pcm.chan[j].env * (pcm.chan[j].pan >> 4)) >> 5);
           }
+
+          pcm.chan[j].addr = addr;
         }
       }
 
-      /* limiter */
-      if (l < -32768) l = -32768;
-      else if (l > 32767) l = 32767;
-      if (r < -32768) r = -32768;
-      else if (r > 32767) r = 32767;
-
-      /* PCM output mixing level (0-100%) */
-      l = (l * config.pcm_volume) / 100;
-      r = (r * config.pcm_volume) / 100;
+      /* limiter & PCM output mixing level (0-100%) */
+      for (i=0; i<n*2; i++)
+      {
+        int out = pcm_mix[i];
+        if (out < -32768) out = -32768;
+        else if (out > 32767) out = 32767;
+        pcm_mix[i] = (out * config.pcm_volume) / 100;
+      }
 
-      /* update blip buffer */
-      blip_add_delta_fast(snd.blips[1], i, l-prev_l, r-prev_r);
-      prev_l = l;
-      prev_r = r;
+      /* update blip buffer (skip unchanged output) */
+      blip_add_samples(snd.blips[1], time, pcm_mix, n, prev);
     }
 
     /* save last audio outputs */
-    pcm.out[0] = prev_l;
-    pcm.out[1] = prev_r;
+    pcm.out[0] = prev[0];
+    pcm.out[1] = prev[1];
   }
   else
   {
-    /* check if PCM output was not muted */
+    /* PCM chip idle: check if PCM output was not muted */
     if (prev_l | prev_r)
     {
       blip_add_delta_fast(snd.blips[1], 0, -prev_l, -prev_r);
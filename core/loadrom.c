@@ -39,6 +39,7 @@
 
 #include <ctype.h>
 #include "shared.h"
+#include "mthread.h"
 
 /*** ROM Information ***/
 #define ROMCONSOLE    256
@@ -58,6 +59,19 @@
 #define ROMMEMO       456
 #define ROMCOUNTRY    496
 
+#ifdef USE_THREADS
+/* large ROM images are processed on multiple threads */
+#define ROM_THREADS_MIN_SIZE  0x200000
+#define ROM_THREADS_MAX       4
+
+typedef struct
+{
+  uint8 *data;
+  int length;
+  uint16 checksum;
+} rom_job_t;
+#endif
+
 #define P3BUTTONS   0x0001
 #define P6BUTTONS   0x0002
 #define PKEYBOARD   0x0004
@@ -211,7 +225,6 @@ static uint16 getchecksum(uint8 *rom, int length)
   return checksum;
 }
 
-
 /***************************************************************************
  * deinterleave_block
  *
@@ -229,6 +242,160 @@ static void deinterleave_block(uint8 * src)
   }
 }
 
+#ifdef LSB_FIRST
+/***************************************************************************
+ *
+ * Byteswap ROM data and compute its real checksum in a single pass.
+ ***************************************************************************/
+static uint16 byteswap_block(uint8 *rom, int length)
+{
+  int i;
+  uint16 checksum = 0;
+  uint16 *data = (uint16 *)rom;
+
+  /* odd length also swaps the following byte */
+  length = (length + 1) >> 1;
+
+  for (i = 0; i < length; i++)
+  {
+    uint16 temp = (uint16)((data[i] << 8) | (data[i] >> 8));
+    data[i] = temp;
+    checksum += temp;
+  }
+
+  return checksum;
+}
+#endif
+
+#ifdef USE_THREADS
+#ifdef LSB_FIRST
+static void byteswap_job(void *arg)
+{
+  rom_job_t *job = (rom_job_t *)arg;
+  job->checksum = byteswap_block(job->data, job->length);
+}
+#endif
+
+static void deinterleave_job(void *arg)
+{
+  int i;
+  rom_job_t *job = (rom_job_t *)arg;
+  for (i = 0; i < job->length; i += 0x4000)
+  {
+    deinterleave_block(job->data + i);
+  }
+}
+
+/***************************************************************************
+ *
+ * Split ROM data in ranges (multiple of unit bytes) processed by each thread.
+ ***************************************************************************/
+static int rom_jobs_init(rom_job_t *jobs, uint8 *data, int length, int unit)
+{
+  int i, size;
+  int count = mt_cpu_count();
+
+  if (count > ROM_THREADS_MAX) count = ROM_THREADS_MAX;
+  if (length < ROM_THREADS_MIN_SIZE) count = 1;
+
+  size = ((length / count) / unit) * unit;
+  if (size == 0) count = 1;
+
+  for (i = 0; i < count; i++)
+  {
+    jobs[i].data = data + i * size;
+    jobs[i].length = (i == (count - 1)) ? (length - i * size) : size;
+    jobs[i].checksum = 0;
+  }
+
+  return count;
+}
+
+static void rom_jobs_run(void (*entry)(void *), rom_job_t *jobs, int count)
+{
+  int i;
+  mt_thread_t threads[ROM_THREADS_MAX];
+  int started[ROM_THREADS_MAX];
+
+  for (i = 1; i < count; i++)
+  {
+    started[i] = mt_thread_create(&threads[i], entry, &jobs[i]);
+  }
+
+  /* first range is processed on the calling thread */
+  entry(&jobs[0]);
+
+  for (i = 1; i < count; i++)
+  {
+    if (started[i])
+    {
+      mt_thread_join(threads[i]);
+    }
+    else
+    {
+      entry(&jobs[i]);
+    }
+  }
+}
+#endif
+
+#ifdef LSB_FIRST
+/***************************************************************************
+ *
+ * Byteswap ROM and compute real checksum (header is not included).
+ ***************************************************************************/
+static uint16 byteswap_rom(uint8 *rom, int length)
+{
+  uint16 checksum = 0;
+
+  if (length <= 0x200)
+  {
+    byteswap_block(rom, length);
+    return 0;
+  }
+
+  byteswap_block(rom, 0x200);
+
+#ifdef USE_THREADS
+  {
+    int i, count;
+    rom_job_t jobs[ROM_THREADS_MAX];
+
+    count = rom_jobs_init(jobs, rom + 0x200, length - 0x200, 64);
+    rom_jobs_run(byteswap_job, jobs, count);
+
+    for (i = 0; i < count; i++)
+    {
+      checksum += jobs[i].checksum;
+    }
+  }
+#else
+  checksum = byteswap_block(rom + 0x200, length - 0x200);
+#endif
+
+  return checksum;
+}
+#endif
+
+/***************************************************************************
+ *
+ * Convert interleaved (.smd) ROM image.
+ ***************************************************************************/
+static void deinterleave_rom(uint8 *rom, int length)
+{
+#ifdef USE_THREADS
+  rom_job_t jobs[ROM_THREADS_MAX];
+  int count = rom_jobs_init(jobs, rom, (length / 0x4000) * 0x4000, 0x4000);
+  rom_jobs_run(deinterleave_job, jobs, count);
+#else
+  int i;
+  for (i = 0; i < (length / 0x4000); i++)
+  {
+    deinterleave_block(rom + (i * 0x4000));
+  }
+#endif
+}
+
 /***************************************************************************
  *
  * Pass a pointer to the ROM base address.
@@ -284,7 +451,6 @@ void getrominfo(char *romheader)
 #ifdef LSB_FIRST
     rominfo.checksum =  (rominfo.checksum >> 8) | ((rominfo.checksum & 0xff) << 8);
 #endif
-    rominfo.realchecksum = getchecksum(((uint8 *) cart.rom) + 0x200, cart.romsize - 0x200);
 
     /* Supported peripherals */
     rominfo.peripherals = 0;
@@ -405,13 +571,13 @@ int load_bios(int system)
         switch (region_code)
         {
           case REGION_USA:
-            size = load_archive(CD_BIOS_US, scd.bootrom, sizeof(scd.bootrom), 0);
+            size = load_bios_archive(CD_BIOS_US, scd.bootrom, sizeof(scd.bootrom), 0);
             break;
           case REGION_EUROPE:
-            size = load_archive(CD_BIOS_EU, scd.bootrom, sizeof(scd.bootrom), 0);
+            size = load_bios_archive(CD_BIOS_EU, scd.bootrom, sizeof(scd.bootrom), 0);
             break;
           default:
-            size = load_archive(CD_BIOS_JP, scd.bootrom, sizeof(scd.bootrom), 0);
+            size = load_bios_archive(CD_BIOS_JP, scd.bootrom, sizeof(scd.bootrom), 0);
             break;
         }
 
@@ -476,7 +642,7 @@ int load_bios(int system)
         if (cart.romsize <= 0x400000)
         {
           /* load Game Gear BOOTROM file */
-          size = load_archive(GG_BIOS, cart.rom + 0x400000, 0x400000, 0);
+          size = load_bios_archive(GG_BIOS, cart.rom + 0x400000, 0x400000, 0);
 
           if (size > 0)
           {
@@ -507,13 +673,13 @@ int load_bios(int system)
           switch (region_code)
           {
             case REGION_USA:
-              size = load_archive(MS_BIOS_US, cart.rom + 0x400000, 0x400000, 0);
+              size = load_bios_archive(MS_BIOS_US, cart.rom + 0x400000, 0x400000, 0);
               break;
             case REGION_EUROPE:
-              size = load_archive(MS_BIOS_EU, cart.rom + 0x400000, 0x400000, 0);
+              size = load_bios_archive(MS_BIOS_EU, cart.rom + 0x400000, 0x400000, 0);
               break;
             default:
-              size = load_archive(MS_BIOS_JP, cart.rom + 0x400000, 0x400000, 0);
+              size = load_bios_archive(MS_BIOS_JP, cart.rom + 0x400000, 0x400000, 0);
               break;
           }
 
@@ -679,10 +845,7 @@ int load_rom(char *filename)
       /* assume interleaved Mega Drive / Genesis ROM format (.smd) */
       if (system_hw == SYSTEM_MD)
       {
-        for (i = 0; i < (size / 0x4000); i++)
-        {
-          deinterleave_block (cart.rom + (i * 0x4000));
-        }
+        deinterleave_rom(cart.rom, size);
       }
     }
   }
@@ -693,22 +856,23 @@ int load_rom(char *filename)
   /* get infos from ROM header */
   getrominfo((char *)(cart.rom));
 
-  /* set console region */
-  get_region((char *)(cart.rom));
-
 #ifdef LSB_FIRST
   /* 16-bit ROM specific */
   if (system_hw == SYSTEM_MD)
   {
-    /* Byteswap ROM to optimize 16-bit access */
-    for (i = 0; i < cart.romsize; i += 2)
-    {
-      uint8 temp = cart.rom[i];
-      cart.rom[i] = cart.rom[i+1];
-      cart.rom[i+1] = temp;
-    }
+    /* Byteswap ROM to optimize 16-bit access (ROM real checksum is computed in the same pass) */
+    rominfo.realchecksum = byteswap_rom(cart.rom, cart.romsize);
   }
+  else
 #endif
+  if (system_hw & SYSTEM_MD)
+  {
+    /* ROM real checksum */
+    rominfo.realchecksum = getchecksum(cart.rom + 0x200, cart.romsize - 0x200);
+  }
+
+  /* set console region */
+  get_region((char *)(cart.rom));
 
   /* PICO ROM */
   if (strstr(rominfo.consoletype, "SEGA PICO") != NULL)
@@ -58,6 +58,8 @@ typedef struct
   unsigned int romend;          /* ROM end address */
   char country[18];             /* Country flag */
   uint16 peripherals;           /* Supported peripherals */
+  unsigned int crc;             /* ROM CRC32 (computed on first use) */
+  uint8 crc_valid;              /* ROM CRC32 has been computed */
 } ROMINFO;
 
 
@@ -0,0 +1,128 @@
+/****************************************************************************
+ *  mthread.c
+ *
+ *  Genesis Plus GX
+ *
+ *  Minimal threading support (optional background workers)
+ *
+ *  This file is distributed under the same terms as Genesis Plus GX
+ *  (see LICENSE.txt).
+ *
+ ****************************************************************************/
+
+#include <stdlib.h>
+#include "mthread.h"
+
+#ifdef USE_THREADS
+
+/* thread entry point & argument */
+typedef struct
+{
+  void (*entry)(void *);
+  void *arg;
+} mt_start_t;
+
+#if defined(_WIN32)
+
+static DWORD WINAPI mt_thread_start(LPVOID param)
+{
+  mt_start_t start = *(mt_start_t *)param;
+  free(param);
+  start.entry(start.arg);
+  return 0;
+}
+
+int mt_thread_create(mt_thread_t *thread, void (*entry)(void *), void *arg)
+{
+  mt_start_t *start = malloc(sizeof(mt_start_t));
+  if (!start) return 0;
+  start->entry = entry;
+  start->arg = arg;
+  *thread = CreateThread(NULL, 0, mt_thread_start, start, 0, NULL);
+  if (!*thread)
+  {
+    free(start);
+    return 0;
+  }
+  return 1;
+}
+
+void mt_thread_join(mt_thread_t thread)
+{
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+}
+
+void mt_mutex_init(mt_mutex_t *mutex)    { InitializeCriticalSection(mutex); }
+void mt_mutex_destroy(mt_mutex_t *mutex) { DeleteCriticalSection(mutex); }
+void mt_mutex_lock(mt_mutex_t *mutex)    { EnterCriticalSection(mutex); }
+void mt_mutex_unlock(mt_mutex_t *mutex)  { LeaveCriticalSection(mutex); }
+
+void mt_cond_init(mt_cond_t *cond)       { InitializeConditionVariable(cond); }
+void mt_cond_destroy(mt_cond_t *cond)    { }
+void mt_cond_wait(mt_cond_t *cond, mt_mutex_t *mutex) { SleepConditionVariableCS(cond, mutex, INFINITE); }
+void mt_cond_signal(mt_cond_t *cond)     { WakeConditionVariable(cond); }
+void mt_cond_broadcast(mt_cond_t *cond)  { WakeAllConditionVariable(cond); }
+
+int mt_cpu_count(void)
+{
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (info.dwNumberOfProcessors > 0) ? info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+#include <unistd.h>
+
+static void *mt_thread_start(void *param)
+{
+  mt_start_t start = *(mt_start_t *)param;
+  free(param);
+  start.entry(start.arg);
+  return NULL;
+}
+
+int mt_thread_create(mt_thread_t *thread, void (*entry)(void *), void *arg)
+{
+  mt_start_t *start = malloc(sizeof(mt_start_t));
+  if (!start) return 0;
+  start->entry = entry;
+  start->arg = arg;
+  if (pthread_create(thread, NULL, mt_thread_start, start))
+  {
+    free(start);
+    return 0;
+  }
+  return 1;
+}
+
+void mt_thread_join(mt_thread_t thread)
+{
+  pthread_join(thread, NULL);
+}
+
+void mt_mutex_init(mt_mutex_t *mutex)    { pthread_mutex_init(mutex, NULL); }
+void mt_mutex_destroy(mt_mutex_t *mutex) { pthread_mutex_destroy(mutex); }
+void mt_mutex_lock(mt_mutex_t *mutex)    { pthread_mutex_lock(mutex); }
+void mt_mutex_unlock(mt_mutex_t *mutex)  { pthread_mutex_unlock(mutex); }
+
+void mt_cond_init(mt_cond_t *cond)       { pthread_cond_init(cond, NULL); }
+void mt_cond_destroy(mt_cond_t *cond)    { pthread_cond_destroy(cond); }
+void mt_cond_wait(mt_cond_t *cond, mt_mutex_t *mutex) { pthread_cond_wait(cond, mutex); }
+void mt_cond_signal(mt_cond_t *cond)     { pthread_cond_signal(cond); }
+void mt_cond_broadcast(mt_cond_t *cond)  { pthread_cond_broadcast(cond); }
+
+int mt_cpu_count(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return (count > 0) ? (int)count : 1;
+#else
+  return 1;
+#endif
+}
+
+#endif
+
+#endif /* USE_THREADS */
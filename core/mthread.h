@@ -0,0 +1,50 @@
+/****************************************************************************
+ *  mthread.h
+ *
+ *  Genesis Plus GX
+ *
+ *  Minimal threading support (optional background workers)
+ *
+ *  This file is distributed under the same terms as Genesis Plus GX
+ *  (see LICENSE.txt).
+ *
+ ****************************************************************************/
+
+#ifndef _MTHREAD_H_
+#define _MTHREAD_H_
+
+/* Threads are only used when USE_THREADS is defined (see Makefile.libretro). */
+/* Emulation itself always runs on the caller thread, workers are only used   */
+/* for host-side tasks (file decoding, decompression, ...) that do not affect */
+/* emulated timings.                                                          */
+#ifdef USE_THREADS
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef HANDLE mt_thread_t;
+typedef CRITICAL_SECTION mt_mutex_t;
+typedef CONDITION_VARIABLE mt_cond_t;
+#else
+#include <pthread.h>
+typedef pthread_t mt_thread_t;
+typedef pthread_mutex_t mt_mutex_t;
+typedef pthread_cond_t mt_cond_t;
+#endif
+
+/* Function prototypes */
+extern int mt_thread_create(mt_thread_t *thread, void (*entry)(void *), void *arg);
+extern void mt_thread_join(mt_thread_t thread);
+extern void mt_mutex_init(mt_mutex_t *mutex);
+extern void mt_mutex_destroy(mt_mutex_t *mutex);
+extern void mt_mutex_lock(mt_mutex_t *mutex);
+extern void mt_mutex_unlock(mt_mutex_t *mutex);
+extern void mt_cond_init(mt_cond_t *cond);
+extern void mt_cond_destroy(mt_cond_t *cond);
+extern void mt_cond_wait(mt_cond_t *cond, mt_mutex_t *mutex);
+extern void mt_cond_signal(mt_cond_t *cond);
+extern void mt_cond_broadcast(mt_cond_t *cond);
+extern int mt_cpu_count(void);
+
+#endif /* USE_THREADS */
+
+#endif /* _MTHREAD_H_ */
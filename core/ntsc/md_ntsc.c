@@ -4,6 +4,7 @@
 
 #include "shared.h"
 #include "md_ntsc.h"
+#include "ntsc_simd.h"
 
 /* Copyright (C) 2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
@@ -86,45 +87,114 @@ void md_ntsc_init( md_ntsc_t* ntsc, md_ntsc_setup_t const* setup )
 }
 
 #ifndef CUSTOM_BLITTER
-void md_ntsc_blit( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* table, unsigned char* input,
-                   int in_width, int vline)
+#ifdef NTSC_SIMD
+/* Generates the eight output pixels of one chunk. Kernels of the four input
+pixels of current (k), previous (p) and second previous (q) chunks are used the
+same way as by MD_NTSC_COLOR_IN / MD_NTSC_RGB_OUT, each output pixel being a
+vector lane. */
+INLINE void md_ntsc_chunk( md_ntsc_rgb_t const* const* k, md_ntsc_rgb_t const* const* p,
+                           md_ntsc_rgb_t const* const* q, md_ntsc_out_t* out )
 {
-  int const chunk_count = in_width / md_ntsc_in_chunk - 1;
+  /* pixels 0-3 */
+  ntsc_v a = NTSC_VADD( NTSC_VADD( NTSC_VLD( k[0] + 0 ), NTSC_VLD2( p[1] + 22, k[1] + 16 ) ),
+                        NTSC_VADD( NTSC_VLD( p[2] + 4 ), NTSC_VLD( p[3] + 18 ) ) );
+  ntsc_v b = NTSC_VADD( NTSC_VADD( NTSC_VLD( p[0] + 8 ), NTSC_VLD2( q[1] + 30, p[1] + 24 ) ),
+                        NTSC_VADD( NTSC_VLD( q[2] + 12 ), NTSC_VLD( q[3] + 26 ) ) );
+  ntsc_v lo = NTSC_VADD( a, b );
+
+  /* pixels 4-7 */
+  ntsc_v c = NTSC_VADD( NTSC_VADD( NTSC_VLD( k[0] + 4 ), NTSC_VLD( k[1] + 18 ) ),
+                        NTSC_VADD( NTSC_VLD( k[2] + 0 ), NTSC_VLD2( p[3] + 22, k[3] + 16 ) ) );
+  ntsc_v d = NTSC_VADD( NTSC_VADD( NTSC_VLD( p[0] + 12 ), NTSC_VLD( p[1] + 26 ) ),
+                        NTSC_VADD( NTSC_VLD( p[2] + 8 ), NTSC_VLD2( q[3] + 30, p[3] + 24 ) ) );
+  ntsc_v hi = NTSC_VADD( c, d );
+
+  ntsc_simd_store( out, ntsc_simd_rgb_out( lo, MD_NTSC_OUT_DEPTH ),
+                   ntsc_simd_rgb_out( hi, MD_NTSC_OUT_DEPTH ), MD_NTSC_OUT_DEPTH, 8 );
+}
 
-  /* use palette entry 0 for unused pixels */
-  MD_NTSC_IN_T border = table[0];
+void md_ntsc_blit_row( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* input, MD_NTSC_IN_T border,
+                        int in_width, void* rgb_out )
+{
+  int n = in_width / md_ntsc_in_chunk - 1;
+  md_ntsc_out_t* restrict line_out = (md_ntsc_out_t*) rgb_out;
+  md_ntsc_rgb_t const* kernel [3] [4];
+  unsigned color;
+
+  /* same as MD_NTSC_BEGIN_ROW */
+  color = border;
+  kernel [1] [0] = kernel [2] [1] = kernel [2] [2] = kernel [2] [3] = MD_NTSC_IN_FORMAT( ntsc, color );
+  color = MD_NTSC_ADJ_IN( input [0] );
+  kernel [1] [1] = MD_NTSC_IN_FORMAT( ntsc, color );
+  color = MD_NTSC_ADJ_IN( input [1] );
+  kernel [1] [2] = MD_NTSC_IN_FORMAT( ntsc, color );
+  color = MD_NTSC_ADJ_IN( input [2] );
+  kernel [1] [3] = MD_NTSC_IN_FORMAT( ntsc, color );
+  input += 3;
+
+  for ( ; n; --n )
+  {
+    color = MD_NTSC_ADJ_IN( input [0] );
+    kernel [0] [0] = MD_NTSC_IN_FORMAT( ntsc, color );
+    color = MD_NTSC_ADJ_IN( input [1] );
+    kernel [0] [1] = MD_NTSC_IN_FORMAT( ntsc, color );
+    color = MD_NTSC_ADJ_IN( input [2] );
+    kernel [0] [2] = MD_NTSC_IN_FORMAT( ntsc, color );
+    color = MD_NTSC_ADJ_IN( input [3] );
+    kernel [0] [3] = MD_NTSC_IN_FORMAT( ntsc, color );
+    input += 4;
+
+    md_ntsc_chunk( kernel [0], kernel [1], kernel [2], line_out );
+    line_out += 8;
+
+    memcpy( kernel [2], kernel [1], sizeof (kernel [1]) );
+    memcpy( kernel [1], kernel [0], sizeof (kernel [0]) );
+  }
+
+  /* finish final pixels */
+  color = MD_NTSC_ADJ_IN( input [0] );
+  kernel [0] [0] = MD_NTSC_IN_FORMAT( ntsc, color );
+  color = border;
+  kernel [0] [1] = kernel [0] [2] = kernel [0] [3] = MD_NTSC_IN_FORMAT( ntsc, color );
+  md_ntsc_chunk( kernel [0], kernel [1], kernel [2], line_out );
+}
+#else
+void md_ntsc_blit_row( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* input, MD_NTSC_IN_T border,
+                        int in_width, void* rgb_out )
+{
+  int const chunk_count = in_width / md_ntsc_in_chunk - 1;
 
   MD_NTSC_BEGIN_ROW( ntsc, border,
-        MD_NTSC_ADJ_IN( table[*input++] ),
-        MD_NTSC_ADJ_IN( table[*input++] ),
-        MD_NTSC_ADJ_IN( table[*input++] ) );
+        MD_NTSC_ADJ_IN( *input++ ),
+        MD_NTSC_ADJ_IN( *input++ ),
+        MD_NTSC_ADJ_IN( *input++ ) );
 
-  md_ntsc_out_t* restrict line_out  = (md_ntsc_out_t*)(&bitmap.data[(vline * bitmap.pitch)]);
+  md_ntsc_out_t* restrict line_out = (md_ntsc_out_t*) rgb_out;
 
   int n;
 
   for ( n = chunk_count; n; --n )
   {
     /* order of input and output pixels must not be altered */
-    MD_NTSC_COLOR_IN( 0, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
+    MD_NTSC_COLOR_IN( 0, ntsc, MD_NTSC_ADJ_IN( *input++ ) );
     MD_NTSC_RGB_OUT( 0, *line_out++ );
     MD_NTSC_RGB_OUT( 1, *line_out++ );
 
-    MD_NTSC_COLOR_IN( 1, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
+    MD_NTSC_COLOR_IN( 1, ntsc, MD_NTSC_ADJ_IN( *input++ ) );
     MD_NTSC_RGB_OUT( 2, *line_out++ );
     MD_NTSC_RGB_OUT( 3, *line_out++ );
 
-    MD_NTSC_COLOR_IN( 2, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
+    MD_NTSC_COLOR_IN( 2, ntsc, MD_NTSC_ADJ_IN( *input++ ) );
     MD_NTSC_RGB_OUT( 4, *line_out++ );
     MD_NTSC_RGB_OUT( 5, *line_out++ );
 
-    MD_NTSC_COLOR_IN( 3, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
+    MD_NTSC_COLOR_IN( 3, ntsc, MD_NTSC_ADJ_IN( *input++ ) );
     MD_NTSC_RGB_OUT( 6, *line_out++ );
     MD_NTSC_RGB_OUT( 7, *line_out++ );
   }
 
   /* finish final pixels */
-  MD_NTSC_COLOR_IN( 0, ntsc, MD_NTSC_ADJ_IN( table[*input++] ) );
+  MD_NTSC_COLOR_IN( 0, ntsc, MD_NTSC_ADJ_IN( *input++ ) );
   MD_NTSC_RGB_OUT( 0, *line_out++ );
   MD_NTSC_RGB_OUT( 1, *line_out++ );
 
@@ -141,3 +211,4 @@ void md_ntsc_blit( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* table, unsigned ch
   MD_NTSC_RGB_OUT( 7, *line_out++ );
 }
 #endif
+#endif
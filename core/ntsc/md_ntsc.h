@@ -51,6 +51,12 @@ In_row_width is the number of pixels to get to the next input row. */
 void md_ntsc_blit( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* table, unsigned char* input,
     int in_width, int vline);
 
+/* Filters one row of pixels already converted to MD_NTSC_IN_T format into
+rgb_out. Border is the color used for unused pixels (palette entry 0). This is
+the built-in blitter, md_ntsc_blit() is only provided by custom blitters. */
+void md_ntsc_blit_row( md_ntsc_t const* ntsc, MD_NTSC_IN_T const* input, MD_NTSC_IN_T border,
+    int in_width, void* rgb_out );
+
 /* Number of output pixels written by blitter for given input width. */
 #define MD_NTSC_OUT_WIDTH( in_width ) \
   (((in_width) - 3) / md_ntsc_in_chunk * md_ntsc_out_chunk + md_ntsc_out_chunk)
@@ -101,7 +107,7 @@ Declares variables, so must be before first statement in a block (unless you're
 
 /* private */
 enum { md_ntsc_entry_size = 2 * 16 };
-typedef unsigned long md_ntsc_rgb_t;
+typedef unsigned int md_ntsc_rgb_t; /* only low 32 bits of packed RGB are used */
 struct md_ntsc_t {
   md_ntsc_rgb_t table [md_ntsc_palette_size] [md_ntsc_entry_size];
 };
@@ -118,6 +124,9 @@ struct md_ntsc_t {
   ((n << 8 & 0x1C00) | (n & 0x0380) | (n >> 8 & 0x0070)) *\
   (md_ntsc_entry_size * sizeof (md_ntsc_rgb_t) / 16))
 
+#define MD_NTSC_RGB32( ntsc, n ) \
+  (ntsc)->table [(n >> 21 & 0x007) | (n >> 10 & 0x038) | (n << 1 & 0x1C0)]
+
 /* common ntsc macros */
 #define md_ntsc_rgb_builder    ((1L << 21) | (1 << 11) | (1 << 1))
 #define md_ntsc_clamp_mask     (md_ntsc_rgb_builder * 3 / 2)
@@ -145,6 +154,10 @@ struct md_ntsc_t {
 #define MD_NTSC_RGB_OUT_( rgb_out, x ) {\
     rgb_out = (raw_>>(13-x)& 0xF800)|(raw_>>(8-x)&0x07E0)|(raw_>>(4-x)&0x001F);\
    }
+#elif MD_NTSC_OUT_DEPTH == 32
+#define MD_NTSC_RGB_OUT_( rgb_out, x ) {\
+    rgb_out = 0xFF000000|(raw_>>(5-x)&0xFF0000)|(raw_>>(3-x)&0x00FF00)|(raw_>>(1-x)&0x0000FF);\
+   }
 #endif
 
 #ifdef __cplusplus
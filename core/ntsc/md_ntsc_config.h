@@ -3,10 +3,13 @@
 #ifndef MD_NTSC_CONFIG_H
 #define MD_NTSC_CONFIG_H
 
-/* Format of source & output pixels (RGB555 or RGB565 only)*/
-#ifdef USE_15BPP_RENDERING
+/* Format of source & output pixels (RGB555, RGB565 or RGB888)*/
+#if defined(USE_15BPP_RENDERING)
 #define MD_NTSC_IN_FORMAT MD_NTSC_RGB15
 #define MD_NTSC_OUT_DEPTH 15
+#elif defined(USE_32BPP_RENDERING)
+#define MD_NTSC_IN_FORMAT MD_NTSC_RGB32
+#define MD_NTSC_OUT_DEPTH 32
 #else
 #define MD_NTSC_IN_FORMAT MD_NTSC_RGB16
 #define MD_NTSC_OUT_DEPTH 16
@@ -18,8 +21,12 @@
 /* The following affect the built-in blitter only; a custom blitter can
 handle things however it wants. */
 
-/* Type of input pixel values (fixed to 16-bit) */
+/* Type of input pixel values (same size as output pixels) */
+#ifdef USE_32BPP_RENDERING
+#define MD_NTSC_IN_T unsigned int
+#else
 #define MD_NTSC_IN_T unsigned short
+#endif
 
 /* Each raw pixel input value is passed through this. You might want to mask
 the pixel index if you use the high bits as flags, etc. */
@@ -0,0 +1,121 @@
+/* SIMD helpers for md_ntsc & sms_ntsc built-in blitters */
+
+/* Added for Genesis Plus GX */
+
+#ifndef NTSC_SIMD_H
+#define NTSC_SIMD_H
+
+/* Packed RGB kernel values are added & clamped as four 32-bit lanes, which
+gives the exact same result as the scalar MD_NTSC_RGB_OUT / SMS_NTSC_RGB_OUT
+macros. */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+  #include <emmintrin.h>
+  #define NTSC_SIMD
+
+  typedef __m128i ntsc_v;
+
+  #define NTSC_VLD( p )        _mm_loadu_si128( (__m128i const*) (p) )
+  #define NTSC_VLD2( p, q )    _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i const*) (p) ),\
+                                                   _mm_loadl_epi64( (__m128i const*) (q) ) )
+  #define NTSC_VST( p, v )     _mm_storeu_si128( (__m128i*) (p), v )
+  #define NTSC_VADD( a, b )    _mm_add_epi32( a, b )
+  #define NTSC_VSUB( a, b )    _mm_sub_epi32( a, b )
+  #define NTSC_VAND( a, b )    _mm_and_si128( a, b )
+  #define NTSC_VOR( a, b )     _mm_or_si128( a, b )
+  #define NTSC_VSHR( a, n )    _mm_srli_epi32( a, n )
+  #define NTSC_VDUP( x )       _mm_set1_epi32( (int) (x) )
+
+  /* no unsigned saturation in SSE2: values are biased to use signed packing */
+  #define NTSC_VST16( p, a, b ) _mm_storeu_si128( (__m128i*) (p), _mm_xor_si128(\
+      _mm_packs_epi32( _mm_sub_epi32( a, _mm_set1_epi32( 0x8000 ) ),\
+                       _mm_sub_epi32( b, _mm_set1_epi32( 0x8000 ) ) ), _mm_set1_epi16( -0x8000 ) ) )
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__) || defined(_M_ARM64)
+  #include <arm_neon.h>
+  #define NTSC_SIMD
+
+  typedef uint32x4_t ntsc_v;
+
+  #define NTSC_VLD( p )        vld1q_u32( (uint32_t const*) (p) )
+  #define NTSC_VLD2( p, q )    vcombine_u32( vld1_u32( (uint32_t const*) (p) ), vld1_u32( (uint32_t const*) (q) ) )
+  #define NTSC_VST( p, v )     vst1q_u32( (uint32_t*) (p), v )
+  #define NTSC_VADD( a, b )    vaddq_u32( a, b )
+  #define NTSC_VSUB( a, b )    vsubq_u32( a, b )
+  #define NTSC_VAND( a, b )    vandq_u32( a, b )
+  #define NTSC_VOR( a, b )     vorrq_u32( a, b )
+  #define NTSC_VSHR( a, n )    vshrq_n_u32( a, n )
+  #define NTSC_VDUP( x )       vdupq_n_u32( x )
+
+  #define NTSC_VST16( p, a, b ) vst1q_u16( (uint16_t*) (p), vcombine_u16( vmovn_u32( a ), vmovn_u32( b ) ) )
+#endif
+
+#ifdef NTSC_SIMD
+
+/* same as md_ntsc_rgb_builder / sms_ntsc_rgb_builder */
+#define ntsc_simd_builder    ((1 << 21) | (1 << 11) | (1 << 1))
+#define ntsc_simd_clamp_mask (ntsc_simd_builder * 3 / 2)
+#define ntsc_simd_clamp_add  (ntsc_simd_builder * 0x101)
+
+/* Clamps and converts four raw values to output pixels of given depth */
+INLINE ntsc_v ntsc_simd_rgb_out( ntsc_v raw, int depth )
+{
+  ntsc_v sub = NTSC_VAND( NTSC_VSHR( raw, 9 ), NTSC_VDUP( ntsc_simd_clamp_mask ) );
+  ntsc_v clamp = NTSC_VSUB( NTSC_VDUP( ntsc_simd_clamp_add ), sub );
+  raw = NTSC_VOR( raw, clamp );
+  clamp = NTSC_VSUB( clamp, sub );
+  raw = NTSC_VAND( raw, clamp );
+
+  if ( depth == 32 )
+    return NTSC_VOR( NTSC_VOR( NTSC_VAND( NTSC_VSHR( raw, 5 ), NTSC_VDUP( 0xFF0000 ) ),
+                               NTSC_VAND( NTSC_VSHR( raw, 3 ), NTSC_VDUP( 0x00FF00 ) ) ),
+                     NTSC_VOR( NTSC_VAND( NTSC_VSHR( raw, 1 ), NTSC_VDUP( 0x0000FF ) ),
+                               NTSC_VDUP( 0xFF000000 ) ) );
+
+  if ( depth == 16 )
+    return NTSC_VOR( NTSC_VOR( NTSC_VAND( NTSC_VSHR( raw, 13 ), NTSC_VDUP( 0xF800 ) ),
+                               NTSC_VAND( NTSC_VSHR( raw, 8 ), NTSC_VDUP( 0x07E0 ) ) ),
+                     NTSC_VAND( NTSC_VSHR( raw, 4 ), NTSC_VDUP( 0x001F ) ) );
+
+  return NTSC_VOR( NTSC_VOR( NTSC_VAND( NTSC_VSHR( raw, 14 ), NTSC_VDUP( 0x7C00 ) ),
+                             NTSC_VAND( NTSC_VSHR( raw, 9 ), NTSC_VDUP( 0x03E0 ) ) ),
+                   NTSC_VAND( NTSC_VSHR( raw, 4 ), NTSC_VDUP( 0x001F ) ) );
+}
+
+/* Writes count (8 or less) output pixels of given depth */
+INLINE void ntsc_simd_store( void* out, ntsc_v a, ntsc_v b, int depth, int count )
+{
+  if ( count == 8 )
+  {
+    if ( depth == 32 )
+    {
+      NTSC_VST( out, a );
+      NTSC_VST( (unsigned int*) out + 4, b );
+    }
+    else
+    {
+      NTSC_VST16( out, a, b );
+    }
+  }
+  else
+  {
+    unsigned int temp [8];
+    NTSC_VST( temp, a );
+    NTSC_VST( temp + 4, b );
+    if ( depth == 32 )
+    {
+      memcpy( out, temp, count * 4 );
+    }
+    else
+    {
+      unsigned short* out16 = (unsigned short*) out;
+      int i;
+      for ( i = 0; i < count; i++ )
+        out16 [i] = (unsigned short) temp [i];
+    }
+  }
+}
+
+#endif
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "shared.h"
 #include "sms_ntsc.h"
+#include "ntsc_simd.h"
 
 /* Copyright (C) 2006-2007 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
@@ -85,8 +86,35 @@ void sms_ntsc_init( sms_ntsc_t* ntsc, sms_ntsc_setup_t const* setup )
 }
 
 #ifndef CUSTOM_BLITTER
-void sms_ntsc_blit( sms_ntsc_t const* ntsc, SMS_NTSC_IN_T const* table, unsigned char* input,
-                    int in_width, int vline)
+#ifdef NTSC_SIMD
+/* Generates the seven output pixels of one chunk. Kernels of the three input
+pixels of current (k), previous (p) and second previous (q) chunks are used the
+same way as by SMS_NTSC_COLOR_IN / SMS_NTSC_RGB_OUT, each output pixel being a
+vector lane. An eighth pixel is written when count is 8, it is overwritten by
+the next chunk. */
+INLINE void sms_ntsc_chunk( sms_ntsc_rgb_t const* const* k, sms_ntsc_rgb_t const* const* p,
+                            sms_ntsc_rgb_t const* const* q, sms_ntsc_out_t* out, int count )
+{
+  /* pixels 0-3 */
+  ntsc_v a = NTSC_VADD( NTSC_VADD( NTSC_VLD( k[0] + 0 ), NTSC_VLD2( p[1] + 19, k[1] + 14 ) ),
+                        NTSC_VLD( p[2] + 31 ) );
+  ntsc_v b = NTSC_VADD( NTSC_VADD( NTSC_VLD( p[0] + 7 ), NTSC_VLD2( q[1] + 26, p[1] + 21 ) ),
+                        NTSC_VLD( q[2] + 38 ) );
+  ntsc_v lo = NTSC_VADD( a, b );
+
+  /* pixels 4-6 */
+  ntsc_v c = NTSC_VADD( NTSC_VADD( NTSC_VLD( k[0] + 4 ), NTSC_VLD( k[1] + 16 ) ),
+                        NTSC_VLD( k[2] + 28 ) );
+  ntsc_v d = NTSC_VADD( NTSC_VADD( NTSC_VLD( p[0] + 11 ), NTSC_VLD( p[1] + 23 ) ),
+                        NTSC_VLD( p[2] + 35 ) );
+  ntsc_v hi = NTSC_VADD( c, d );
+
+  ntsc_simd_store( out, ntsc_simd_rgb_out( lo, SMS_NTSC_OUT_DEPTH ),
+                   ntsc_simd_rgb_out( hi, SMS_NTSC_OUT_DEPTH ), SMS_NTSC_OUT_DEPTH, count );
+}
+
+void sms_ntsc_blit_row( sms_ntsc_t const* ntsc, SMS_NTSC_IN_T const* input, SMS_NTSC_IN_T border,
+                         int in_width, void* rgb_out )
 {
   int n;
   int const chunk_count = in_width / sms_ntsc_in_chunk;
@@ -96,29 +124,74 @@ void sms_ntsc_blit( sms_ntsc_t const* ntsc, SMS_NTSC_IN_T const* table, unsigned
   unsigned const extra2 = (unsigned) -(in_extra >> 1 & 1); /* (unsigned) -1 = ~0 */
   unsigned const extra1 = (unsigned) -(in_extra & 1) | extra2;
 
-  /* use palette entry 0 for unused pixels */
-  SMS_NTSC_IN_T border = table[0];
+  sms_ntsc_out_t* line_out = (sms_ntsc_out_t*) rgb_out;
+  sms_ntsc_rgb_t const* kernel [3] [3];
+  unsigned color;
+
+  /* same as SMS_NTSC_BEGIN_ROW */
+  color = border;
+  kernel [1] [0] = kernel [2] [1] = kernel [2] [2] = SMS_NTSC_IN_FORMAT( ntsc, color );
+  color = (SMS_NTSC_ADJ_IN( input [0] )) & extra2;
+  kernel [1] [1] = SMS_NTSC_IN_FORMAT( ntsc, color );
+  color = (SMS_NTSC_ADJ_IN( input [extra2 & 1] )) & extra1;
+  kernel [1] [2] = SMS_NTSC_IN_FORMAT( ntsc, color );
+
+  input += in_extra;
+
+  for ( n = chunk_count; n; --n )
+  {
+    color = SMS_NTSC_ADJ_IN( input [0] );
+    kernel [0] [0] = SMS_NTSC_IN_FORMAT( ntsc, color );
+    color = SMS_NTSC_ADJ_IN( input [1] );
+    kernel [0] [1] = SMS_NTSC_IN_FORMAT( ntsc, color );
+    color = SMS_NTSC_ADJ_IN( input [2] );
+    kernel [0] [2] = SMS_NTSC_IN_FORMAT( ntsc, color );
+    input += 3;
+
+    sms_ntsc_chunk( kernel [0], kernel [1], kernel [2], line_out, 8 );
+    line_out += 7;
+
+    memcpy( kernel [2], kernel [1], sizeof (kernel [1]) );
+    memcpy( kernel [1], kernel [0], sizeof (kernel [0]) );
+  }
+
+  /* finish final pixels */
+  color = border;
+  kernel [0] [0] = kernel [0] [1] = kernel [0] [2] = SMS_NTSC_IN_FORMAT( ntsc, color );
+  sms_ntsc_chunk( kernel [0], kernel [1], kernel [2], line_out, 7 );
+}
+#else
+void sms_ntsc_blit_row( sms_ntsc_t const* ntsc, SMS_NTSC_IN_T const* input, SMS_NTSC_IN_T border,
+                         int in_width, void* rgb_out )
+{
+  int n;
+  int const chunk_count = in_width / sms_ntsc_in_chunk;
+
+  /* handle extra 0, 1, or 2 pixels by placing them at beginning of row */
+  int const in_extra = in_width - chunk_count * sms_ntsc_in_chunk;
+  unsigned const extra2 = (unsigned) -(in_extra >> 1 & 1); /* (unsigned) -1 = ~0 */
+  unsigned const extra1 = (unsigned) -(in_extra & 1) | extra2;
 
   SMS_NTSC_BEGIN_ROW( ntsc, border,
-      (SMS_NTSC_ADJ_IN( table[input[0]] )) & extra2,
-      (SMS_NTSC_ADJ_IN( table[input[extra2 & 1]] )) & extra1 );
+      (SMS_NTSC_ADJ_IN( input[0] )) & extra2,
+      (SMS_NTSC_ADJ_IN( input[extra2 & 1] )) & extra1 );
 
-  sms_ntsc_out_t* line_out  = (sms_ntsc_out_t*)(&bitmap.data[(vline * bitmap.pitch)]);
+  sms_ntsc_out_t* line_out = (sms_ntsc_out_t*) rgb_out;
 
   input += in_extra;
 
   for ( n = chunk_count; n; --n )
   {
     /* order of input and output pixels must not be altered */
-    SMS_NTSC_COLOR_IN( 0, ntsc, SMS_NTSC_ADJ_IN( table[*input++] ) );
+    SMS_NTSC_COLOR_IN( 0, ntsc, SMS_NTSC_ADJ_IN( *input++ ) );
     SMS_NTSC_RGB_OUT( 0, *line_out++ );
     SMS_NTSC_RGB_OUT( 1, *line_out++ );
     
-    SMS_NTSC_COLOR_IN( 1, ntsc, SMS_NTSC_ADJ_IN( table[*input++] ) );
+    SMS_NTSC_COLOR_IN( 1, ntsc, SMS_NTSC_ADJ_IN( *input++ ) );
     SMS_NTSC_RGB_OUT( 2, *line_out++ );
     SMS_NTSC_RGB_OUT( 3, *line_out++ );
       
-    SMS_NTSC_COLOR_IN( 2, ntsc, SMS_NTSC_ADJ_IN( table[*input++] ) );
+    SMS_NTSC_COLOR_IN( 2, ntsc, SMS_NTSC_ADJ_IN( *input++ ) );
     SMS_NTSC_RGB_OUT( 4, *line_out++ );
     SMS_NTSC_RGB_OUT( 5, *line_out++ );
     SMS_NTSC_RGB_OUT( 6, *line_out++ );
@@ -139,3 +212,4 @@ void sms_ntsc_blit( sms_ntsc_t const* ntsc, SMS_NTSC_IN_T const* table, unsigned
   SMS_NTSC_RGB_OUT( 6, *line_out++ );
 }
 #endif
+#endif
@@ -51,6 +51,12 @@ In_row_width is the number of pixels to get to the next input row. */
 void sms_ntsc_blit( sms_ntsc_t const* ntsc, SMS_NTSC_IN_T const* table, unsigned char* input,
     int in_width, int vline);
 
+/* Filters one row of pixels already converted to SMS_NTSC_IN_T format into
+rgb_out. Border is the color used for unused pixels (palette entry 0). This is
+the built-in blitter, sms_ntsc_blit() is only provided by custom blitters. */
+void sms_ntsc_blit_row( sms_ntsc_t const* ntsc, SMS_NTSC_IN_T const* input, SMS_NTSC_IN_T border,
+    int in_width, void* rgb_out );
+
 /* Number of output pixels written by blitter for given input width. */
 #define SMS_NTSC_OUT_WIDTH( in_width ) \
   (((in_width) / sms_ntsc_in_chunk + 1) * sms_ntsc_out_chunk)
@@ -87,7 +93,7 @@ Declares variables, so must be before first statement in a block (unless you're
 
 /* private */
 enum { sms_ntsc_entry_size = 3 * 14 };
-typedef unsigned long sms_ntsc_rgb_t;
+typedef unsigned int sms_ntsc_rgb_t; /* only low 32 bits of packed RGB are used */
 struct sms_ntsc_t {
   sms_ntsc_rgb_t table [sms_ntsc_palette_size] [sms_ntsc_entry_size];
 };
@@ -104,6 +110,9 @@ struct sms_ntsc_t {
   ((n << 9 & 0x3C00) | (n & 0x03C0) | (n >> 9 & 0x003C)) *\
   (sms_ntsc_entry_size * sizeof (sms_ntsc_rgb_t) / 4))
 
+#define SMS_NTSC_RGB32( ntsc, n ) \
+  (ntsc)->table [(n >> 20 & 0x00F) | (n >> 8 & 0x0F0) | (n << 4 & 0xF00)]
+
 /* common 3->7 ntsc macros */
 #define SMS_NTSC_BEGIN_ROW_6_( pixel0, pixel1, pixel2, ENTRY, table ) \
   sms_ntsc_rgb_t raw_;\
@@ -145,6 +154,10 @@ struct sms_ntsc_t {
 #define SMS_NTSC_RGB_OUT_( rgb_out, x) {\
     rgb_out = (raw_>>(13-x)& 0xF800)|(raw_>>(8-x)&0x07E0)|(raw_>>(4-x)&0x001F);\
    }
+#elif SMS_NTSC_OUT_DEPTH == 32
+#define SMS_NTSC_RGB_OUT_( rgb_out, x) {\
+    rgb_out = 0xFF000000|(raw_>>(5-x)&0xFF0000)|(raw_>>(3-x)&0x00FF00)|(raw_>>(1-x)&0x0000FF);\
+   }
 #endif
 
 #ifdef __cplusplus
@@ -568,6 +568,64 @@ void blip_add_delta_fast( blip_t* m, unsigned time, int delta_l, int delta_r )
 	blip_add_delta(m, time, delta_l, delta_r);
 }
 
+void blip_add_samples( blip_t* m, unsigned time, const int samples [], int count, int last [2] )
+{
+	int i;
+	int last_l = last[0];
+	int last_r = last[1];
+
+#ifdef BLIP_INVERT
+	buf_t* out_l = m->buffer[1];
+	buf_t* out_r = m->buffer[0];
+#else
+	buf_t* out_l = m->buffer[0];
+	buf_t* out_r = m->buffer[1];
+#endif
+
+	if ( m->factor == time_unit )
+	{
+		/* one output sample per clock: positions are consecutive */
+		int pos = (fixed_t) (time * m->factor + m->offset) >> time_bits;
+
+		for ( i = 0; i < count; i++, pos++ )
+		{
+			int l = samples[i*2];
+			int r = samples[i*2+1];
+
+			if ( (l != last_l) || (r != last_r) )
+			{
+				blip_lpf_stereo(m->sample_rate, out_l + pos, out_r + pos, l - last_l, r - last_r);
+				last_l = l;
+				last_r = r;
+			}
+		}
+	}
+	else
+	{
+		for ( i = 0; i < count; i++ )
+		{
+			int l = samples[i*2];
+			int r = samples[i*2+1];
+
+			if ( (l != last_l) || (r != last_r) )
+			{
+				int pos = (fixed_t) ((time + i) * m->factor + m->offset) >> time_bits;
+				blip_lpf_stereo(m->sample_rate, out_l + pos, out_r + pos, l - last_l, r - last_r);
+				last_l = l;
+				last_r = r;
+			}
+		}
+	}
+
+#ifdef BLIP_ASSERT
+	/* Fails if buffer size was exceeded */
+	assert( (((fixed_t) ((time + count) * m->factor + m->offset)) >> time_bits) <= m->size );
+#endif
+
+	last[0] = last_l;
+	last[1] = last_r;
+}
+
 #else
 
 void blip_add_delta( blip_t* m, unsigned time, int delta )
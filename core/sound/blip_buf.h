@@ -53,6 +53,11 @@ void blip_add_delta( blip_t*, unsigned time, int delta_l, int delta_r );
 /** Same as blip_add_delta(), but uses faster, lower-quality synthesis. */
 void blip_add_delta_fast( blip_t*, unsigned time, int delta_l, int delta_r );
 
+/** Adds 'count' interleaved stereo amplitudes, one per clock starting at specified
+clock time. Deltas are taken against 'last' amplitudes, which are updated on return.
+Output positions are computed once when clock rate equals sample rate. */
+void blip_add_samples( blip_t*, unsigned time, const int samples [], int count, int last [2] );
+
 #else
 
 /** Adds positive/negative delta into buffer at specified clock time. */
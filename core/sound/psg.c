@@ -494,6 +494,25 @@ static void psg_update(unsigned int clocks)
     /* Tone channels */
     if (i < 3)
     {
+      /* muted channel: only keep generator phase in sync */
+      if (!(psg.chanOut[i][0] | psg.chanOut[i][1]))
+      {
+        if (timestamp < clocks)
+        {
+          /* number of transitions occurring until current clock timestamp */
+          int count = (clocks - timestamp + psg.freqInc[i] - 1) / psg.freqInc[i];
+
+          /* generator polarity is inverted on each transition */
+          if (count & 1)
+          {
+            polarity = -polarity;
+          }
+
+          /* timestamp of next transition */
+          timestamp += count * psg.freqInc[i];
+        }
+      }
+
       /* process all transitions occurring until current clock timestamp */
       while (timestamp < clocks)
       {
@@ -550,14 +569,17 @@ static void psg_update(unsigned int clocks)
           /* shift register output variation */
           shiftOutput = (shiftValue & 0x1) - shiftOutput;
 
-          /* update noise channel output */
-          if (config.hq_psg)
-          {
-            blip_add_delta(snd.blips[0], timestamp, shiftOutput*psg.chanOut[3][0], shiftOutput*psg.chanOut[3][1]);
-          }
-          else
+          /* update noise channel output (unless muted) */
+          if (psg.chanOut[3][0] | psg.chanOut[3][1])
           {
-            blip_add_delta_fast(snd.blips[0], timestamp, shiftOutput*psg.chanOut[3][0], shiftOutput*psg.chanOut[3][1]);
+            if (config.hq_psg)
+            {
+              blip_add_delta(snd.blips[0], timestamp, shiftOutput*psg.chanOut[3][0], shiftOutput*psg.chanOut[3][1]);
+            }
+            else
+            {
+              blip_add_delta_fast(snd.blips[0], timestamp, shiftOutput*psg.chanOut[3][0], shiftOutput*psg.chanOut[3][1]);
+            }
           }
         }
 
@@ -479,9 +479,14 @@ int sound_update(unsigned int cycles)
           /* left & right channels */
           l = ((*ptr++ * preamp) / 100);
           r = ((*ptr++ * preamp) / 100);
-          blip_add_delta(snd.blips[0], time, l - prev_l, r - prev_r);
-          prev_l = l;
-          prev_r = r;
+
+          /* skip unchanged output (silent or idle chip) */
+          if ((l != prev_l) || (r != prev_r))
+          {
+            blip_add_delta(snd.blips[0], time, l - prev_l, r - prev_r);
+            prev_l = l;
+            prev_r = r;
+          }
 
           /* increment time counter */
           time += fm_cycles_ratio;
@@ -495,9 +500,14 @@ int sound_update(unsigned int cycles)
           /* left & right channels */
           l = ((*ptr++ * preamp) / 100);
           r = ((*ptr++ * preamp) / 100);
-          blip_add_delta_fast(snd.blips[0], time, l - prev_l, r - prev_r);
-          prev_l = l;
-          prev_r = r;
+
+          /* skip unchanged output (silent or idle chip) */
+          if ((l != prev_l) || (r != prev_r))
+          {
+            blip_add_delta_fast(snd.blips[0], time, l - prev_l, r - prev_r);
+            prev_l = l;
+            prev_r = r;
+          }
 
           /* increment time counter */
           time += fm_cycles_ratio;
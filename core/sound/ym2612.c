@@ -2002,6 +2002,88 @@ unsigned int YM2612Read(void)
   return ym2612.OPN.ST.status;
 }
 
+/* check if chip output is silent and will remain so until next register write */
+INLINE int is_chip_idle(void)
+{
+  int c, s;
+
+  /* DAC output or CSM mode (Timer A triggers Key ON) */
+  if (ym2612.dacen || ym2612.OPN.SL3.key_csm || ((ym2612.OPN.ST.mode & 0xC0) == 0x80))
+    return 0;
+
+  for (c=0; c<6; c++)
+  {
+    FM_CH *CH = &ym2612.CH[c];
+
+    /* pending feedback or delayed (MEM) samples */
+    if (CH->op1_out[0] | CH->op1_out[1] | CH->mem_value)
+      return 0;
+
+    for (s=0; s<4; s++)
+    {
+      /* Phase Generator is restarted on next Key ON so it does not need to be updated */
+      if ((CH->SLOT[s].state != EG_OFF) || CH->SLOT[s].key)
+        return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* advance chip internal counters without generating any output */
+INLINE void advance_idle(int length)
+{
+  UINT32 steps;
+
+  /* EG counter (12-bit, zero value skipped) */
+  ym2612.OPN.eg_timer += length;
+  steps = ym2612.OPN.eg_timer / 3;
+  ym2612.OPN.eg_timer %= 3;
+  if (steps)
+  {
+    ym2612.OPN.eg_cnt = ((ym2612.OPN.eg_cnt + 4094 + (steps % 4095)) % 4095) + 1;
+  }
+
+  /* LFO */
+  if (ym2612.OPN.lfo_timer_overflow)
+  {
+    ym2612.OPN.lfo_timer += length;
+    steps = ym2612.OPN.lfo_timer / ym2612.OPN.lfo_timer_overflow;
+    ym2612.OPN.lfo_timer %= ym2612.OPN.lfo_timer_overflow;
+    if (steps)
+    {
+      ym2612.OPN.lfo_cnt = (ym2612.OPN.lfo_cnt + steps) & 127;
+      if (ym2612.OPN.lfo_cnt<64)
+        ym2612.OPN.LFO_AM = (ym2612.OPN.lfo_cnt ^ 63) << 1;
+      else
+        ym2612.OPN.LFO_AM = (ym2612.OPN.lfo_cnt & 63) << 1;
+      ym2612.OPN.LFO_PM = ym2612.OPN.lfo_cnt >> 2;
+    }
+  }
+
+  /* Timer A (decremented every sample, reloaded on overflow) */
+  if (ym2612.OPN.ST.mode & 0x01)
+  {
+    while (length > 0)
+    {
+      int count = (ym2612.OPN.ST.TAC > 0) ? ym2612.OPN.ST.TAC : 1;
+      if (count > length)
+      {
+        ym2612.OPN.ST.TAC -= length;
+        break;
+      }
+
+      /* set status (if enabled) */
+      if (ym2612.OPN.ST.mode & 0x04)
+        ym2612.OPN.ST.status |= 0x01;
+
+      /* reload the counter */
+      ym2612.OPN.ST.TAC = ym2612.OPN.ST.TAL;
+      length -= count;
+    }
+  }
+}
+
 /* Generate samples for ym2612 */
 void YM2612Update(int *buffer, int length)
 {
@@ -2032,6 +2114,26 @@ void YM2612Update(int *buffer, int length)
   refresh_fc_eg_chan(&ym2612.CH[4]);
   refresh_fc_eg_chan(&ym2612.CH[5]);
 
+  /* all channels keyed off and released, DAC disabled */
+  if (is_chip_idle())
+  {
+    /* constant output (discrete YM2612 DAC 'ladder effect' offset on each channel) */
+    lt = (chip_type == YM2612_DISCRETE) ? (6 * (4 << 5)) : 0;
+
+    for(i=0; i<length; i++)
+    {
+      *buffer++ = lt;
+      *buffer++ = lt;
+    }
+
+    /* keep EG, LFO & timers in sync */
+    advance_idle(length);
+
+    /* timer B control */
+    INTERNAL_TIMER_B(length);
+    return;
+  }
+
   /* buffering */
   for(i=0; i<length; i++)
   {
@@ -364,6 +364,9 @@ void system_frame_gen(int do_skip)
   fifo_cycles[2] = 0;
   fifo_cycles[3] = 0;
 
+  /* reset skipped lines counter */
+  render_skipped_lines = 0;
+
   /* check if display setings have changed during previous frame */
   if (bitmap.viewport.changed & 2)
   {
@@ -677,6 +680,9 @@ void system_frame_gen(int do_skip)
   }
   while (++line < bitmap.viewport.h);
 
+  /* apply frame post-processing */
+  render_end_frame();
+
   /* check viewport changes */
   if (bitmap.viewport.w != bitmap.viewport.ow)
   {
@@ -707,6 +713,9 @@ void system_frame_scd(int do_skip)
   fifo_cycles[2] = 0;
   fifo_cycles[3] = 0;
 
+  /* reset skipped lines counter */
+  render_skipped_lines = 0;
+
   /* check if display setings have changed during previous frame */
   if (bitmap.viewport.changed & 2)
   {
@@ -1004,6 +1013,9 @@ void system_frame_scd(int do_skip)
   }
   while (++line < bitmap.viewport.h);
 
+  /* apply frame post-processing */
+  render_end_frame();
+
   /* check viewport changes */
   if (bitmap.viewport.w != bitmap.viewport.ow)
   {
@@ -1414,6 +1426,9 @@ void system_frame_sms(int do_skip)
   }
   while (++line < bitmap.viewport.h);
 
+  /* apply frame post-processing */
+  render_end_frame();
+
   /* check viewport changes */
   if (bitmap.viewport.w != bitmap.viewport.ow)
   {
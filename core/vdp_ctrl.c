@@ -103,6 +103,7 @@ uint16 hscb;                      /* Horizontal scroll table base address */
 uint8 bg_name_dirty[0x800];       /* 1= This pattern is dirty */
 uint16 bg_name_list[0x800];       /* List of modified pattern indices */
 uint16 bg_list_index;             /* # of modified patterns in list */
+uint8 sat_dirty;                  /* 1= Internal SAT has been modified */
 uint8 hscroll_mask;               /* Horizontal Scrolling line mask */
 uint8 playfield_shift;            /* Width of planes A, B (in bits) */
 uint8 playfield_col_mask;         /* Playfield column mask */
@@ -282,6 +283,7 @@ void vdp_reset(void)
     memset((char *)vsram, 0, sizeof(vsram));
   }
   memset((char *)reg, 0, sizeof(reg));
+  sat_dirty = 1;
 
   addr            = 0;
   addr_latch      = 0;
@@ -517,6 +519,7 @@ int vdp_context_load(uint8 *state)
   do_not_invalidate_tile_cache = true;
 
   load_param(sat, sizeof(sat));
+  sat_dirty = 1;
   state_vram_ptr = &state[bufferptr];
   bufferptr += sizeof(vram);
   load_param(cram, sizeof(cram));
@@ -2300,6 +2303,7 @@ static void vdp_bus_w(unsigned int data)
       {
         /* Update internal SAT */
         *(uint16 *) &sat[index & sat_addr_mask] = data;
+        sat_dirty = 1;
       }
 
       /* Only write unique data to VRAM */
@@ -2452,6 +2456,116 @@ static void vdp_bus_w(unsigned int data)
   addr += reg[15];
 }
 
+#if !defined(LOGVDP) && !defined(DEBUG_VDP) && !defined(DEBUG_DMA)
+/* Check if DMA can write VRAM in blocks (per-word logging disables it) */
+INLINE int vdp_bus_vram_block(void)
+{
+#ifdef HOOK_CPU
+  if (UNLIKELY(cpu_hook))
+    return 0;
+#endif
+
+  /* VRAM destination with auto-increment of 2 */
+  return ((code & 0x0F) == 0x01) && (reg[15] == 2);
+}
+
+/* Write a block of data words to VRAM, same as 'count' calls to vdp_bus_w */
+/* Caller ensures the block does not cross the end of VRAM address space.   */
+static void vdp_bus_w_vram(const uint16 *src, unsigned int count)
+{
+  /* VRAM address */
+  int index = addr & 0xFFFE;
+
+  /* Pointer to VRAM */
+  uint16 *p = (uint16 *)&vram[index];
+
+  /* Pattern cache dirty bits are accumulated per pattern */
+  int name, last = -1, dirty = 0;
+  unsigned int i, start, end;
+
+  if( debug_dma == 1 ) {
+    debug_dma_once = 1;
+    debug_dma = 2;
+  }
+
+  for (i = 0; i < count; i++, index += 2)
+  {
+    unsigned int data = src[i];
+
+    /* Byte-swap data if A0 is set */
+    if (addr & 1)
+    {
+      data = ((data >> 8) | (data << 8)) & 0xFFFF;
+    }
+
+    /* Only write unique data to VRAM */
+    if (data != p[i])
+    {
+      /* Write data to VRAM */
+      p[i] = data;
+
+      /* Flush dirty bits when moving to another pattern */
+      name = (index >> 5) & 0x7FF;
+      if (name != last)
+      {
+        if (dirty)
+        {
+          if (bg_name_dirty[last] == 0)
+          {
+            bg_name_list[bg_list_index++] = last;
+          }
+          bg_name_dirty[last] |= dirty;
+        }
+        last = name;
+        dirty = 0;
+      }
+      dirty |= (1 << ((index >> 2) & 7));
+    }
+  }
+
+  /* Update pattern cache */
+  if (dirty)
+  {
+    if (bg_name_dirty[last] == 0)
+    {
+      bg_name_list[bg_list_index++] = last;
+    }
+    bg_name_dirty[last] |= dirty;
+  }
+
+  /* Intercept writes to Sprite Attribute Table */
+  start = addr & 0xFFFE;
+  end = start + (count << 1);
+  if (start < satb)
+  {
+    start = satb;
+  }
+  if (end > (satb + sat_addr_mask + 1U))
+  {
+    end = satb + sat_addr_mask + 1U;
+  }
+  if (start < end)
+  {
+    /* Update internal SAT */
+    memcpy(&sat[start & sat_addr_mask], &vram[start], end - start);
+    sat_dirty = 1;
+  }
+
+  /* Only the last four data words remain in FIFO */
+  for (i = (count > 4) ? (count - 4) : 0; i < count; i++)
+  {
+    fifo[fifo_idx] = src[i];
+    fifo_idx = (fifo_idx + 1) & 3;
+  }
+
+  /* Increment address register */
+  addr += (count << 1);
+}
+#else
+#define vdp_bus_vram_block() (0)
+#define vdp_bus_w_vram(src, count)
+#endif
+
 
 /*--------------------------------------------------------------------------*/
 /* 68k bus interface (Mega Drive VDP only)                                     */
@@ -2816,6 +2930,7 @@ static void vdp_z80_data_w_m5(unsigned int data)
       {
         /* Update internal SAT */
         WRITE_BYTE(sat, index & sat_addr_mask, data);
+        sat_dirty = 1;
       }
 
       /* Only write unique data to VRAM */
@@ -3173,6 +3288,51 @@ static void vdp_dma_68k_ext(unsigned int length)
 
 	if( debug_dma == 0 ) debug_dma = 1;
 
+  /* DMA to VRAM: copy directly mapped source areas in blocks */
+  if (vdp_bus_vram_block())
+  {
+    do
+    {
+      unsigned int count;
+
+      /* Read data word from 68k bus handler */
+      if (m68k.memory_map[source>>16].read16)
+      {
+        vdp_bus_w(m68k.memory_map[source>>16].read16(source));
+        count = 1;
+      }
+      else
+      {
+        /* Stop at end of source 64k bank or VRAM address space */
+        count = (0x10000 - (source & 0xFFFF)) >> 1;
+        if (count > ((0x10000 - (addr & 0xFFFE)) >> 1))
+        {
+          count = (0x10000 - (addr & 0xFFFE)) >> 1;
+        }
+        if (count > length)
+        {
+          count = length;
+        }
+
+        /* Write data words to VRAM */
+        vdp_bus_w_vram((uint16 *)(m68k.memory_map[source>>16].base + (source & 0xFFFF)), count);
+      }
+
+      /* Increment source address */
+      source += (count << 1);
+
+      /* 128k DMA window */
+      source = (reg[23] << 17) | (source & 0x1FFFF);
+
+      length -= count;
+    }
+    while (length);
+
+    /* Update DMA source address */
+    dma_src = (source >> 1) & 0xffff;
+    return;
+  }
+
   do
   {
     /* Read data word from 68k bus */
@@ -3210,6 +3370,40 @@ static void vdp_dma_68k_ram(unsigned int length)
 
 	if( debug_dma == 0 ) debug_dma = 1;
 
+  /* DMA to VRAM: copy Work-RAM in blocks */
+  if (vdp_bus_vram_block())
+  {
+    do
+    {
+      /* Stop at end of Work-RAM or VRAM address space */
+      unsigned int count = (0x10000 - (source & 0xFFFF)) >> 1;
+      if (count > ((0x10000 - (addr & 0xFFFE)) >> 1))
+      {
+        count = (0x10000 - (addr & 0xFFFE)) >> 1;
+      }
+      if (count > length)
+      {
+        count = length;
+      }
+
+      /* Write data words to VRAM */
+      vdp_bus_w_vram((uint16 *)(work_ram + (source & 0xFFFF)), count);
+
+      /* Increment source address */
+      source += (count << 1);
+
+      /* 128k DMA window */
+      source = (reg[23] << 17) | (source & 0x1FFFF);
+
+      length -= count;
+    }
+    while (length);
+
+    /* Update DMA source address */
+    dma_src = (source >> 1) & 0xffff;
+    return;
+  }
+
   do
   {
     /* access Work-RAM by default  */
@@ -3280,6 +3474,72 @@ static void vdp_dma_68k_io(unsigned int length)
   dma_src = (source >> 1) & 0xffff;
 }
 
+/* Mark VRAM bytes [start, end) as modified in pattern cache */
+static void vdp_bg_dirty_span(unsigned int start, unsigned int end)
+{
+  int name;
+
+  while (start < end)
+  {
+    /* Last byte of current pattern within span */
+    unsigned int last = start | 0x1F;
+    if (last >= end)
+    {
+      last = end - 1;
+    }
+
+    name = (start >> 5) & 0x7FF;
+    if (bg_name_dirty[name] == 0)
+    {
+      bg_name_list[bg_list_index++] = name;
+    }
+
+    /* Pattern lines from first to last modified byte */
+    bg_name_dirty[name] |= (0xFF << ((start >> 2) & 7)) & (0xFF >> (7 - ((last >> 2) & 7)));
+
+    start = last + 1;
+  }
+}
+
+/* Update internal SAT with VRAM bytes [start, end) */
+static void vdp_sat_update_span(unsigned int start, unsigned int end)
+{
+  /* Clip span to Sprite Attribute Table */
+  if (start < satb)
+  {
+    start = satb;
+  }
+  if (end > (satb + sat_addr_mask + 1U))
+  {
+    end = satb + sat_addr_mask + 1U;
+  }
+
+  if (start < end)
+  {
+    sat_dirty = 1;
+
+    /* Odd first byte */
+    if (start & 1)
+    {
+      WRITE_BYTE(sat, (start & sat_addr_mask) ^ 1, READ_BYTE(vram, start ^ 1));
+      start++;
+    }
+
+    /* Odd last byte */
+    if (end & 1)
+    {
+      end--;
+      WRITE_BYTE(sat, (end & sat_addr_mask) ^ 1, READ_BYTE(vram, end ^ 1));
+    }
+
+    /* Whole words */
+    if (start < end)
+    {
+      memcpy(&sat[start & sat_addr_mask], &vram[start], end - start);
+    }
+  }
+}
+
 /*  VRAM Copy */
 static void vdp_dma_copy(unsigned int length)
 {
@@ -3296,6 +3556,55 @@ static void vdp_dma_copy(unsigned int length)
 
     do
     {
+      /* Auto-increment of 1: copy contiguous spans */
+      if (reg[15] == 1)
+      {
+        /* Stop at end of VRAM source or destination address space */
+        unsigned int start = addr;
+        unsigned int count = 0x10000 - ((start > source) ? start : source);
+        if (count > length)
+        {
+          count = length;
+        }
+
+        /* Same byte order in source and destination words, and no overlap */
+        /* with source bytes not yet read (copy is done byte per byte)      */
+        if (!((start ^ source) & 1) && ((start <= source) || (start >= (source + count))))
+        {
+          unsigned int end = start + count;
+          unsigned int offset = source - start;
+
+          /* Odd first byte */
+          if (start & 1)
+          {
+            WRITE_BYTE(vram, start ^ 1, READ_BYTE(vram, source ^ 1));
+            start++;
+          }
+
+          /* Whole words */
+          if ((end & ~1) > start)
+          {
+            memmove(&vram[start], &vram[start + offset], (end & ~1) - start);
+          }
+
+          /* Odd last byte */
+          if (end & 1)
+          {
+            WRITE_BYTE(vram, (end - 1) ^ 1, READ_BYTE(vram, (end - 1 + offset) ^ 1));
+          }
+
+          /* Update internal SAT and pattern cache */
+          vdp_sat_update_span(addr, addr + count);
+          vdp_bg_dirty_span(addr, addr + count);
+
+          /* Increment VRAM source & destination addresses */
+          source += count;
+          addr += count;
+          length -= count;
+          continue;
+        }
+      }
+
       /* Read byte from adjacent VRAM source address */
       data = READ_BYTE(vram, source ^ 1);
 
@@ -3304,6 +3613,7 @@ static void vdp_dma_copy(unsigned int length)
       {
         /* Update internal SAT */
         WRITE_BYTE(sat, (addr & sat_addr_mask) ^ 1, data);
+        sat_dirty = 1;
       }
 
       /* Write byte to adjacent VRAM destination address */
@@ -3317,8 +3627,9 @@ static void vdp_dma_copy(unsigned int length)
 
       /* Increment VRAM destination address */
       addr += reg[15];
+      length--;
     }
-    while (--length);
+    while (length);
 
     /* Update DMA source address */
     dma_src = source;
@@ -3340,6 +3651,52 @@ static void vdp_dma_fill(unsigned int length)
       /* Get source data from last written FIFO entry */
       uint8 data = fifo[(fifo_idx+3)&3] >> 8;
 
+      /* Auto-increment of 1: fill contiguous spans */
+      if (reg[15] == 1)
+      {
+        do
+        {
+          /* Stop at end of VRAM address space */
+          unsigned int start = addr;
+          unsigned int count = 0x10000 - start;
+          unsigned int end;
+          if (count > length)
+          {
+            count = length;
+          }
+          end = start + count;
+
+          /* Odd first byte */
+          if (start & 1)
+          {
+            WRITE_BYTE(vram, start ^ 1, data);
+            start++;
+          }
+
+          /* Whole words */
+          if ((end & ~1) > start)
+          {
+            memset(&vram[start], data, (end & ~1) - start);
+          }
+
+          /* Odd last byte */
+          if (end & 1)
+          {
+            WRITE_BYTE(vram, (end - 1) ^ 1, data);
+          }
+
+          /* Update internal SAT and pattern cache */
+          vdp_sat_update_span(addr, end);
+          vdp_bg_dirty_span(addr, end);
+
+          /* Increment VRAM address */
+          addr += count;
+          length -= count;
+        }
+        while (length);
+        break;
+      }
+
       do
       {
         /* Intercept writes to Sprite Attribute Table */
@@ -3347,6 +3704,7 @@ static void vdp_dma_fill(unsigned int length)
         {
           /* Update internal SAT */
           WRITE_BYTE(sat, (addr & sat_addr_mask) ^ 1, data);
+          sat_dirty = 1;
         }
 
         /* Write byte to adjacent VRAM address */
@@ -64,6 +64,7 @@ extern uint16 hscb;
 extern uint8 bg_name_dirty[0x800];
 extern uint16 bg_name_list[0x800];
 extern uint16 bg_list_index;
+extern uint8 sat_dirty;
 extern uint8 hscroll_mask;
 extern uint8 playfield_shift;
 extern uint8 playfield_col_mask;
@@ -0,0 +1,374 @@
+/***************************************************************************************
+ *  Genesis Plus
+ *  Video Display Processor (rendering look-up tables)
+ *
+ *  Copyright (C) 1998, 1999, 2000, 2001, 2002, 2003  Charles Mac Donald (original code)
+ *  Copyright (C) 2007-2016  Eke-Eke (Genesis Plus GX)
+ *
+ *  Redistribution and use of this code or any derivative works are permitted
+ *  provided that the following conditions are met:
+ *
+ *   - Redistributions may not be sold, nor may they be used in a commercial
+ *     product or activity.
+ *
+ *   - Redistributions that are modified from the original source must include the
+ *     complete source code, including the source code for all components used by a
+ *     binary built from the modified sources. However, as a special exception, the
+ *     source code distributed need not include anything that is normally distributed
+ *     (in either source or binary form) with the major components (compiler, kernel,
+ *     and so on) of the operating system on which the executable runs, unless that
+ *     component itself accompanies the executable.
+ *
+ *   - Redistributions must reproduce the above copyright notice, this list of
+ *     conditions and the following disclaimer in the documentation and/or other
+ *     materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************************/
+
+#ifndef _VDP_LUT_H_
+#define _VDP_LUT_H_
+
+/* Pixel priority look-up tables information */
+#define LUT_MAX     (6)
+#define LUT_SIZE    (0x10000)
+
+/* Look-up tables are either generated at startup (default) or at build time */
+/* with USE_STATIC_LUTS, in which case this file is only used by lutgen tool */
+#ifndef USE_STATIC_LUTS
+
+/*--------------------------------------------------------------------------*/
+/* Sprite pattern name offset look-up table function (Mode 5)               */
+/*--------------------------------------------------------------------------*/
+
+static void make_name_lut(uint8 *name_lut)
+{
+  int vcol, vrow;
+  int width, height;
+  int flipx, flipy;
+  int i;
+
+  for (i = 0; i < 0x400; i += 1)
+  {
+    /* Sprite settings */
+    vcol = i & 3;
+    vrow = (i >> 2) & 3;
+    height = (i >> 4) & 3;
+    width  = (i >> 6) & 3;
+    flipx  = (i >> 8) & 1;
+    flipy  = (i >> 9) & 1;
+
+    if ((vrow > height) || vcol > width)
+    {
+      /* Invalid settings (unused) */
+      name_lut[i] = -1;
+    }
+    else
+    {
+      /* Adjust column & row index if sprite is flipped */
+      if(flipx) vcol = (width - vcol);
+      if(flipy) vrow = (height - vrow);
+
+      /* Pattern offset (pattern order is up->down->left->right) */
+      name_lut[i] = vrow + (vcol * (height + 1));
+    }
+  }
+}
+
+
+/*--------------------------------------------------------------------------*/
+/* Layers priority pixel look-up tables functions                           */
+/*--------------------------------------------------------------------------*/
+
+/* Input (bx):  d5-d0=color, d6=priority, d7=unused */
+/* Input (ax):  d5-d0=color, d6=priority, d7=unused */
+/* Output:    d5-d0=color, d6=priority, d7=zero */
+static uint32 make_lut_bg(uint32 bx, uint32 ax)
+{
+  int bf = (bx & 0x7F);
+  int bp = (bx & 0x40);
+  int b  = (bx & 0x0F);
+
+  int af = (ax & 0x7F);
+  int ap = (ax & 0x40);
+  int a  = (ax & 0x0F);
+
+  int c = (ap ? (a ? af : bf) : (bp ? (b ? bf : af) : (a ? af : bf)));
+
+  /* Strip palette & priority bits from transparent pixels */
+  if((c & 0x0F) == 0x00) c &= 0x80;
+
+  return (c);
+}
+
+/* Input (bx):  d5-d0=color, d6=priority, d7=unused */
+/* Input (sx):  d5-d0=color, d6=priority, d7=unused */
+/* Output:    d5-d0=color, d6=priority, d7=intensity select (0=half/1=normal) */
+static uint32 make_lut_bg_ste(uint32 bx, uint32 ax)
+{
+  int bf = (bx & 0x7F);
+  int bp = (bx & 0x40);
+  int b  = (bx & 0x0F);
+
+  int af = (ax & 0x7F);
+  int ap = (ax & 0x40);
+  int a  = (ax & 0x0F);
+
+  int c = (ap ? (a ? af : bf) : (bp ? (b ? bf : af) : (a ? af : bf)));
+
+  /* Half intensity when both pixels are low priority */
+  c |= ((ap | bp) << 1);
+
+  /* Strip palette & priority bits from transparent pixels */
+  if((c & 0x0F) == 0x00) c &= 0x80;
+
+  return (c);
+}
+
+/* Input (bx):  d5-d0=color, d6=priority/1, d7=sprite pixel marker */
+/* Input (sx):  d5-d0=color, d6=priority, d7=unused */
+/* Output:    d5-d0=color, d6=priority, d7=sprite pixel marker */
+static uint32 make_lut_obj(uint32 bx, uint32 sx)
+{
+  int c;
+
+  int bf = (bx & 0x7F);
+  int bs = (bx & 0x80);
+  int sf = (sx & 0x7F);
+
+  if((sx & 0x0F) == 0) return bx;
+
+  c = (bs ? bf : sf);
+
+  /* Strip palette bits from transparent pixels */
+  if((c & 0x0F) == 0x00) c &= 0xC0;
+
+  return (c | 0x80);
+}
+
+
+/* Input (bx):  d5-d0=color, d6=priority, d7=opaque sprite pixel marker */
+/* Input (sx):  d5-d0=color, d6=priority, d7=unused */
+/* Output:    d5-d0=color, d6=zero/priority, d7=opaque sprite pixel marker */
+static uint32 make_lut_bgobj(uint32 bx, uint32 sx)
+{
+  int c;
+
+  int bf = (bx & 0x3F);
+  int bs = (bx & 0x80);
+  int bp = (bx & 0x40);
+  int b  = (bx & 0x0F);
+
+  int sf = (sx & 0x3F);
+  int sp = (sx & 0x40);
+  int s  = (sx & 0x0F);
+
+  if(s == 0) return bx;
+
+  /* Previous sprite has higher priority */
+  if(bs) return bx;
+
+  c = (sp ? sf : (bp ? (b ? bf : sf) : sf));
+
+  /* Strip palette & priority bits from transparent pixels */
+  if((c & 0x0F) == 0x00) c &= 0x80;
+
+  return (c | 0x80);
+}
+
+/* Input (bx):  d5-d0=color, d6=priority, d7=intensity (half/normal) */
+/* Input (sx):  d5-d0=color, d6=priority, d7=sprite marker */
+/* Output:    d5-d0=color, d6=intensity (half/normal), d7=(double/invalid) */
+static uint32 make_lut_bgobj_ste(uint32 bx, uint32 sx)
+{
+  int c;
+
+  int bf = (bx & 0x3F);
+  int bp = (bx & 0x40);
+  int b  = (bx & 0x0F);
+  int bi = (bx & 0x80) >> 1;
+
+  int sf = (sx & 0x3F);
+  int sp = (sx & 0x40);
+  int s  = (sx & 0x0F);
+  int si = sp | bi;
+
+  if(sp)
+  {
+    if(s)
+    {
+      if((sf & 0x3E) == 0x3E)
+      {
+        if(sf & 1)
+        {
+          c = (bf | 0x00);
+        }
+        else
+        {
+          c = (bx & 0x80) ? (bf | 0x80) : (bf | 0x40);
+        }
+      }
+      else
+      {
+        if(sf == 0x0E || sf == 0x1E || sf == 0x2E)
+        {
+          c = (sf | 0x40);
+        }
+        else
+        {
+          c = (sf | si);
+        }
+      }
+    }
+    else
+    {
+      c = (bf | bi);
+    }
+  }
+  else
+  {
+    if(bp)
+    {
+      if(b)
+      {
+        c = (bf | bi);
+      }
+      else
+      {
+        if(s)
+        {
+          if((sf & 0x3E) == 0x3E)
+          {
+            if(sf & 1)
+            {
+              c = (bf | 0x00);
+            }
+            else
+            {
+              c = (bx & 0x80) ? (bf | 0x80) : (bf | 0x40);
+            }
+          }
+          else
+          {
+            if(sf == 0x0E || sf == 0x1E || sf == 0x2E)
+            {
+              c = (sf | 0x40);
+            }
+            else
+            {
+              c = (sf | si);
+            }
+          }
+        }
+        else
+        {
+          c = (bf | bi);
+        }
+      }
+    }
+    else
+    {
+      if(s)
+      {
+        if((sf & 0x3E) == 0x3E)
+        {
+          if(sf & 1)
+          {
+            c = (bf | 0x00);
+          }
+          else
+          {
+            c = (bx & 0x80) ? (bf | 0x80) : (bf | 0x40);
+          }
+        }
+        else
+        {
+          if(sf == 0x0E || sf == 0x1E || sf == 0x2E)
+          {
+            c = (sf | 0x40);
+          }
+          else
+          {
+            c = (sf | si);
+          }
+        }
+      }
+      else
+      {
+        c = (bf | bi);
+      }
+    }
+  }
+
+  if((c & 0x0f) == 0x00) c &= 0xC0;
+
+  return (c);
+}
+
+/* Input (bx):  d3-d0=color, d4=palette, d5=priority, d6=zero, d7=sprite pixel marker */
+/* Input (sx):  d3-d0=color, d7-d4=zero */
+/* Output:      d3-d0=color, d4=palette, d5=zero/priority, d6=zero, d7=sprite pixel marker */
+static uint32 make_lut_bgobj_m4(uint32 bx, uint32 sx)
+{
+  int c;
+
+  int bf = (bx & 0x3F);
+  int bs = (bx & 0x80);
+  int bp = (bx & 0x20);
+  int b  = (bx & 0x0F);
+
+  int s  = (sx & 0x0F);
+  int sf = (s | 0x10); /* force palette bit */
+
+  /* Transparent sprite pixel */
+  if(s == 0) return bx;
+
+  /* Previous sprite has higher priority */
+  if(bs) return bx;
+
+  /* note: priority bit is always 0 for Modes 0,1,2,3 */
+  c = (bp ? (b ? bf : sf) : sf);
+
+  return (c | 0x80);
+}
+
+
+/*--------------------------------------------------------------------------*/
+/* Layers priority pixel look-up tables initialization                      */
+/*--------------------------------------------------------------------------*/
+
+static void make_lut(uint8 lut[LUT_MAX][LUT_SIZE])
+{
+  int bx, ax;
+  uint16 index;
+
+  for (bx = 0; bx < 0x100; bx++)
+  {
+    for (ax = 0; ax < 0x100; ax++)
+    {
+      index = (bx << 8) | (ax);
+
+      lut[0][index] = make_lut_bg(bx, ax);
+      lut[1][index] = make_lut_bgobj(bx, ax);
+      lut[2][index] = make_lut_bg_ste(bx, ax);
+      lut[3][index] = make_lut_obj(bx, ax);
+      lut[4][index] = make_lut_bgobj_ste(bx, ax);
+      lut[5][index] = make_lut_bgobj_m4(bx,ax);
+    }
+  }
+}
+
+#endif /* USE_STATIC_LUTS */
+
+#endif /* _VDP_LUT_H_ */
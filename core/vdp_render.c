@@ -43,6 +43,8 @@
 #include "shared.h"
 #include "md_ntsc.h"
 #include "sms_ntsc.h"
+#include "vdp_lut.h"
+#include "mthread.h"
 
 extern int8 reset_do_not_clear_buffers;
 
@@ -68,10 +70,10 @@ extern sms_ntsc_t *sms_ntsc;
 #define PIXEL_OUT_T uint16
 #endif
 
-
-/* Pixel priority look-up tables information */
-#define LUT_MAX     (6)
-#define LUT_SIZE    (0x10000)
+/* NTSC filter is applied once all frame lines have been rendered (built-in blitter only) */
+#if !defined(USE_8BPP_RENDERING) && !defined(CUSTOM_BLITTER)
+#define NTSC_FRAME_FILTER
+#endif
 
 
 #ifdef ALIGN_LONG
@@ -120,6 +122,86 @@ INLINE void WRITE_LONG(void *address, uint32 data)
 #endif  /* ALIGN_LONG */
 
 
+/* Reverse pixels order in 4 cached pattern pixels */
+/* (compiled as byte-reverse instruction on most CPU) */
+#define HFLIP_LONG(x) \
+  (((x) >> 24) | (((x) >> 8) & 0x0000FF00) | (((x) << 8) & 0x00FF0000) | ((x) << 24))
+
+#ifdef USE_COMPACT_PATTERN_CACHE
+/* Mode 5 patterns are only cached once: vertical flip is done by reading */
+/* pattern rows in reverse order and horizontal flip by reversing cached  */
+/* pattern line bytes                                                     */
+#define HFLIP_TILE(SRC) \
+  hflip_tile[0] = HFLIP_LONG(SRC[1]); \
+  hflip_tile[1] = HFLIP_LONG(SRC[0]);
+
+/* Draw 2-cell column (8-pixels high) */
+/*
+   Pattern cache base address: NNNNNNNN NNNYYYxxx
+   with :
+      x = Pattern Pixel (0-7)
+      Y = Pattern Row (0-7), reversed if Vertical Flip bit is set
+      N = Pattern Number (0-2047) from pattern attribute
+*/
+#define GET_LSB_TILE(ATTR, LINE) \
+  atex = atex_table[(ATTR >> 13) & 7]; \
+  src = (uint32 *)&bg_pattern_cache[(ATTR & 0x000007FF) << 6 | ((LINE) ^ ((ATTR & 0x00001000) ? 0x38 : 0x00))]; \
+  if (ATTR & 0x00000800) \
+  { \
+    HFLIP_TILE(src) \
+    src = hflip_tile; \
+  }
+#define GET_MSB_TILE(ATTR, LINE) \
+  atex = atex_table[(ATTR >> 29) & 7]; \
+  src = (uint32 *)&bg_pattern_cache[(ATTR & 0x07FF0000) >> 10 | ((LINE) ^ ((ATTR & 0x10000000) ? 0x38 : 0x00))]; \
+  if (ATTR & 0x08000000) \
+  { \
+    HFLIP_TILE(src) \
+    src = hflip_tile; \
+  }
+
+/* Draw 2-cell column (16 pixels high) */
+/*
+   Pattern cache base address: NNNNNNNN NNYYYYxxx
+   with :
+      x = Pattern Pixel (0-7)
+      Y = Pattern Row (0-15), reversed if Vertical Flip bit is set
+      N = Pattern Number (0-1023)
+*/
+#define GET_LSB_TILE_IM2(ATTR, LINE) \
+  atex = atex_table[(ATTR >> 13) & 7]; \
+  src = (uint32 *)&bg_pattern_cache[(ATTR & 0x000003FF) << 7 | ((LINE) ^ ((ATTR & 0x00001000) ? 0x78 : 0x00))]; \
+  if (ATTR & 0x00000800) \
+  { \
+    HFLIP_TILE(src) \
+    src = hflip_tile; \
+  }
+#define GET_MSB_TILE_IM2(ATTR, LINE) \
+  atex = atex_table[(ATTR >> 29) & 7]; \
+  src = (uint32 *)&bg_pattern_cache[(ATTR & 0x03FF0000) >> 9 | ((LINE) ^ ((ATTR & 0x10000000) ? 0x78 : 0x00))]; \
+  if (ATTR & 0x08000000) \
+  { \
+    HFLIP_TILE(src) \
+    src = hflip_tile; \
+  }
+
+/* Sprite pattern (ATTR = masked vflip/hflip bits) */
+#define GET_SPRITE_TILE(ATTR, NAME, LINE) \
+  src = &bg_pattern_cache[((NAME) << 6) | ((LINE) ^ (((ATTR) & 0x1000) ? 0x38 : 0x00))]; \
+  if ((ATTR) & 0x0800) \
+  { \
+    HFLIP_TILE(((uint32 *)src)) \
+    src = (uint8 *)hflip_tile; \
+  }
+#define GET_SPRITE_TILE_IM2(ATTR, NAME, LINE) \
+  src = &bg_pattern_cache[((NAME) << 6) | ((LINE) ^ (((ATTR) & 0x1000) ? 0x78 : 0x00))]; \
+  if ((ATTR) & 0x0800) \
+  { \
+    HFLIP_TILE(((uint32 *)src)) \
+    src = (uint8 *)hflip_tile; \
+  }
+
+#else
 /* Draw 2-cell column (8-pixels high) */
 /*
    Pattern cache base address: VHN NNNNNNNN NNYYYxxx
@@ -154,6 +236,13 @@ INLINE void WRITE_LONG(void *address, uint32 data)
   atex = atex_table[(ATTR >> 29) & 7]; \
   src = (uint32 *)&bg_pattern_cache[((ATTR & 0x03FF0000) >> 9 | (ATTR & 0x18000000) >> 10 | (LINE)) ^ ((ATTR & 0x10000000) >> 22)];
 
+/* Sprite pattern (ATTR = masked vflip/hflip bits) */
+#define GET_SPRITE_TILE(ATTR, NAME, LINE) \
+  src = &bg_pattern_cache[(((ATTR) | (NAME)) << 6) | (LINE)];
+#define GET_SPRITE_TILE_IM2(ATTR, NAME, LINE) \
+  src = &bg_pattern_cache[((((ATTR) | (NAME)) << 6) | (LINE)) ^ (((ATTR) & 0x1000) >> 6)];
+#endif /* USE_COMPACT_PATTERN_CACHE */
+
 /*
    One column = 2 tiles
    Two pattern attributes are written in VRAM as two consecutives 16-bit words:
@@ -563,17 +652,28 @@ static const uint32 tms_palette[16] =
 };
 #endif
 
+#ifdef USE_COMPACT_PATTERN_CACHE
+/* Cached patterns (Mode 5) or cached and flipped patterns (Mode 4) */
+static uint8 ALIGNED_(4) bg_pattern_cache[0x20000];
+
+/* Horizontally flipped pattern line */
+static uint32 hflip_tile[2];
+#else
 /* Cached and flipped patterns */
 static uint8 ALIGNED_(4) bg_pattern_cache[0x80000];
+#endif
 
+#ifdef USE_STATIC_LUTS
+/* Sprite pattern name offset & layer priority pixel look-up tables */
+/* generated at build time (see libretro/lutgen.c)                  */
+#include "vdp_lut_data.h"
+#else
 /* Sprite pattern name offset look-up table (Mode 5) */
 static uint8 name_lut[0x400];
 
-/* Bitplane to packed pixel look-up table (Mode 4) */
-static uint32 bp_lut[0x10000];
-
 /* Layer priority pixel look-up tables */
 static uint8 lut[LUT_MAX][LUT_SIZE];
+#endif
 
 /* Output pixel data look-up tables*/
 static PIXEL_OUT_T pixel[0x100];
@@ -597,364 +697,114 @@ typedef struct
 
 static object_info_t obj_info[2][MAX_SPRITES_PER_LINE];
 
-/* Sprite Counter */
-static uint8 object_count[2];
-
-/* Sprite Collision Info */
-uint16 spr_col;
-
-/* Function pointers */
-void (*render_bg)(int line);
-void (*render_obj)(int line);
-void (*parse_satb)(int line);
-void (*update_bg_pattern_cache)(int index);
-
-
-/*--------------------------------------------------------------------------*/
-/* Sprite pattern name offset look-up table function (Mode 5)               */
-/*--------------------------------------------------------------------------*/
-
-static void make_name_lut(void)
-{
-  int vcol, vrow;
-  int width, height;
-  int flipx, flipy;
-  int i;
-
-  for (i = 0; i < 0x400; i += 1)
-  {
-    /* Sprite settings */
-    vcol = i & 3;
-    vrow = (i >> 2) & 3;
-    height = (i >> 4) & 3;
-    width  = (i >> 6) & 3;
-    flipx  = (i >> 8) & 1;
-    flipy  = (i >> 9) & 1;
-
-    if ((vrow > height) || vcol > width)
-    {
-      /* Invalid settings (unused) */
-      name_lut[i] = -1;
-    }
-    else
-    {
-      /* Adjust column & row index if sprite is flipped */
-      if(flipx) vcol = (width - vcol);
-      if(flipy) vrow = (height - vrow);
-
-      /* Pattern offset (pattern order is up->down->left->right) */
-      name_lut[i] = vrow + (vcol * (height + 1));
-    }
-  }
-}
-
-
-/*--------------------------------------------------------------------------*/
-/* Bitplane to packed pixel look-up table function (Mode 4)                 */
-/*--------------------------------------------------------------------------*/
-
-static void make_bp_lut(void)
-{
-  int x,i,j;
-  uint32 out;
-
-  /* ---------------------- */
-  /* Pattern color encoding */
-  /* -------------------------------------------------------------------------*/
-  /* 4 byteplanes are required to define one pattern line (8 pixels)          */
-  /* A single pixel color is coded with 4 bits (c3 c2 c1 c0)                  */
-  /* Each bit is coming from byteplane bits, as explained below:              */
-  /* pixel 0: c3 = bp3 bit 7, c2 = bp2 bit 7, c1 = bp1 bit 7, c0 = bp0 bit 7  */
-  /* pixel 1: c3 = bp3 bit 6, c2 = bp2 bit 6, c1 = bp1 bit 6, c0 = bp0 bit 6  */
-  /* ...                                                                      */
-  /* pixel 7: c3 = bp3 bit 0, c2 = bp2 bit 0, c1 = bp1 bit 0, c0 = bp0 bit 0  */
-  /* -------------------------------------------------------------------------*/
-
-  for(i = 0; i < 0x100; i++)
-  for(j = 0; j < 0x100; j++)
-  {
-    out = 0;
-    for(x = 0; x < 8; x++)
-    {
-      /* pixel line data = hh00gg00ff00ee00dd00cc00bb00aa00 (32-bit) */
-      /* aa-hh = upper or lower 2-bit values of pixels 0-7 (shifted) */
-      out |= (j & (0x80 >> x)) ? (uint32)(8 << (x << 2)) : 0;
-      out |= (i & (0x80 >> x)) ? (uint32)(4 << (x << 2)) : 0;
-    }
-
-    /* i = low byte in VRAM  (bp0 or bp2) */
-    /* j = high byte in VRAM (bp1 or bp3) */
- #ifdef LSB_FIRST
-    bp_lut[(j << 8) | (i)] = out;
- #else
-    bp_lut[(i << 8) | (j)] = out;
- #endif
-   }
-}
-
-
-/*--------------------------------------------------------------------------*/
-/* Layers priority pixel look-up tables functions                           */
-/*--------------------------------------------------------------------------*/
-
-/* Input (bx):  d5-d0=color, d6=priority, d7=unused */
-/* Input (ax):  d5-d0=color, d6=priority, d7=unused */
-/* Output:    d5-d0=color, d6=priority, d7=zero */
-static uint32 make_lut_bg(uint32 bx, uint32 ax)
-{
-  int bf = (bx & 0x7F);
-  int bp = (bx & 0x40);
-  int b  = (bx & 0x0F);
-
-  int af = (ax & 0x7F);
-  int ap = (ax & 0x40);
-  int a  = (ax & 0x0F);
-
-  int c = (ap ? (a ? af : bf) : (bp ? (b ? bf : af) : (a ? af : bf)));
+/* Mode 5 sprite index (internal SAT link list sorted by line, rebuilt only when needed) */
+#define SPRITE_INDEX_LINES 0x220  /* max. Y position + max. sprite height */
+#define SPRITE_INDEX_MAX 80       /* max. parsed sprites (max_sprite_pixels >> 2) */
 
-  /* Strip palette & priority bits from transparent pixels */
-  if((c & 0x0F) == 0x00) c &= 0x80;
-
-  return (c);
-}
-
-/* Input (bx):  d5-d0=color, d6=priority, d7=unused */
-/* Input (sx):  d5-d0=color, d6=priority, d7=unused */
-/* Output:    d5-d0=color, d6=priority, d7=intensity select (0=half/1=normal) */
-static uint32 make_lut_bg_ste(uint32 bx, uint32 ax)
+typedef struct
 {
-  int bf = (bx & 0x7F);
-  int bp = (bx & 0x40);
-  int b  = (bx & 0x0F);
+  uint16 link;  /* SAT entry offset (16-bit words) */
+  uint16 ypos;  /* first line */
+  uint16 size;  /* sprite size */
+} sprite_entry_t;
 
-  int af = (ax & 0x7F);
-  int ap = (ax & 0x40);
-  int a  = (ax & 0x0F);
-
-  int c = (ap ? (a ? af : bf) : (bp ? (b ? bf : af) : (a ? af : bf)));
-
-  /* Half intensity when both pixels are low priority */
-  c |= ((ap | bp) << 1);
-
-  /* Strip palette & priority bits from transparent pixels */
-  if((c & 0x0F) == 0x00) c &= 0x80;
-
-  return (c);
-}
-
-/* Input (bx):  d5-d0=color, d6=priority/1, d7=sprite pixel marker */
-/* Input (sx):  d5-d0=color, d6=priority, d7=unused */
-/* Output:    d5-d0=color, d6=priority, d7=sprite pixel marker */
-static uint32 make_lut_obj(uint32 bx, uint32 sx)
+static struct
 {
-  int c;
-
-  int bf = (bx & 0x7F);
-  int bs = (bx & 0x80);
-  int sf = (sx & 0x7F);
-
-  if((sx & 0x0F) == 0) return bx;
+  sprite_entry_t entry[SPRITE_INDEX_MAX];           /* parsed SAT entries, in link order */
+  uint8 count[SPRITE_INDEX_LINES];                  /* number of entries on each line */
+  uint8 list[SPRITE_INDEX_LINES][SPRITE_INDEX_MAX]; /* entries on each line, in link order */
+  int width;                                        /* parameters used to build the index */
+  int total;
+  int im2;
+} sprite_index;
 
-  c = (bs ? bf : sf);
-
-  /* Strip palette bits from transparent pixels */
-  if((c & 0x0F) == 0x00) c &= 0xC0;
+/* Sprite Counter */
+static uint8 object_count[2];
 
-  return (c | 0x80);
-}
+/* Sprite Collision Info */
+uint16 spr_col;
 
+/* Line cache (unchanged Mode 5 lines are not rendered again) */
+#define LINE_CACHE_LINES 576
+#define LINE_CACHE_WIDTH 0x180
+#define LINE_CACHE_KEY (29 + 2*MAX_SPRITES_PER_LINE)
 
-/* Input (bx):  d5-d0=color, d6=priority, d7=opaque sprite pixel marker */
-/* Input (sx):  d5-d0=color, d6=priority, d7=unused */
-/* Output:    d5-d0=color, d6=zero/priority, d7=opaque sprite pixel marker */
-static uint32 make_lut_bgobj(uint32 bx, uint32 sx)
+typedef struct
 {
-  int c;
-
-  int bf = (bx & 0x3F);
-  int bs = (bx & 0x80);
-  int bp = (bx & 0x40);
-  int b  = (bx & 0x0F);
+  uint32 key[LINE_CACHE_KEY]; /* line inputs (registers, VSRAM, sprites, viewport) */
+  uint32 size;      /* line inputs size */
+  uint32 vram;      /* VRAM serial */
+  uint32 color;     /* palette serial */
+  uint8 valid;
+  uint8 spr_ovr;    /* sprite masking flag after line rendering */
+} line_cache_t;
 
-  int sf = (sx & 0x3F);
-  int sp = (sx & 0x40);
-  int s  = (sx & 0x0F);
+static line_cache_t line_cache[LINE_CACHE_LINES];
+static uint8 line_cache_buf[LINE_CACHE_LINES][LINE_CACHE_WIDTH];
 
-  if(s == 0) return bx;
+/* Incremented each time VRAM or color palette is modified */
+static uint32 vram_serial;
+static uint32 color_serial;
 
-  /* Previous sprite has higher priority */
-  if(bs) return bx;
+/* Rendering functions used by cached lines */
+static void (*line_cache_bg)(int line);
+static void (*line_cache_obj)(int line);
 
-  c = (sp ? sf : (bp ? (b ? bf : sf) : sf));
+/* Number of lines skipped during current frame */
+uint32 render_skipped_lines;
 
-  /* Strip palette & priority bits from transparent pixels */
-  if((c & 0x0F) == 0x00) c &= 0x80;
+#ifdef NTSC_FRAME_FILTER
+#define NTSC_MAX_LINES 576
+#define NTSC_MAX_WIDTH 0x180
 
-  return (c | 0x80);
-}
+/* Converted pixels of framebuffer lines waiting to be filtered */
+static PIXEL_OUT_T *ntsc_buf;
 
-/* Input (bx):  d5-d0=color, d6=priority, d7=intensity (half/normal) */
-/* Input (sx):  d5-d0=color, d6=priority, d7=sprite marker */
-/* Output:    d5-d0=color, d6=intensity (half/normal), d7=(double/invalid) */
-static uint32 make_lut_bgobj_ste(uint32 bx, uint32 sx)
+static struct
 {
-  int c;
-
-  int bf = (bx & 0x3F);
-  int bp = (bx & 0x40);
-  int b  = (bx & 0x0F);
-  int bi = (bx & 0x80) >> 1;
+  uint16 width;       /* input width (0 if line is not pending) */
+  uint8 md;           /* md_ntsc (Mode 5) or sms_ntsc filter */
+  PIXEL_OUT_T border; /* palette entry 0 */
+} ntsc_line[NTSC_MAX_LINES];
 
-  int sf = (sx & 0x3F);
-  int sp = (sx & 0x40);
-  int s  = (sx & 0x0F);
-  int si = sp | bi;
-
-  if(sp)
-  {
-    if(s)
-    {
-      if((sf & 0x3E) == 0x3E)
-      {
-        if(sf & 1)
-        {
-          c = (bf | 0x00);
-        }
-        else
-        {
-          c = (bx & 0x80) ? (bf | 0x80) : (bf | 0x40);
-        }
-      }
-      else
-      {
-        if(sf == 0x0E || sf == 0x1E || sf == 0x2E)
-        {
-          c = (sf | 0x40);
-        }
-        else
-        {
-          c = (sf | si);
-        }
-      }
-    }
-    else
-    {
-      c = (bf | bi);
-    }
-  }
-  else
-  {
-    if(bp)
-    {
-      if(b)
-      {
-        c = (bf | bi);
-      }
-      else
-      {
-        if(s)
-        {
-          if((sf & 0x3E) == 0x3E)
-          {
-            if(sf & 1)
-            {
-              c = (bf | 0x00);
-            }
-            else
-            {
-              c = (bx & 0x80) ? (bf | 0x80) : (bf | 0x40);
-            }
-          }
-          else
-          {
-            if(sf == 0x0E || sf == 0x1E || sf == 0x2E)
-            {
-              c = (sf | 0x40);
-            }
-            else
-            {
-              c = (sf | si);
-            }
-          }
-        }
-        else
-        {
-          c = (bf | bi);
-        }
-      }
-    }
-    else
-    {
-      if(s)
-      {
-        if((sf & 0x3E) == 0x3E)
-        {
-          if(sf & 1)
-          {
-            c = (bf | 0x00);
-          }
-          else
-          {
-            c = (bx & 0x80) ? (bf | 0x80) : (bf | 0x40);
-          }
-        }
-        else
-        {
-          if(sf == 0x0E || sf == 0x1E || sf == 0x2E)
-          {
-            c = (sf | 0x40);
-          }
-          else
-          {
-            c = (sf | si);
-          }
-        }
-      }
-      else
-      {
-        c = (bf | bi);
-      }
-    }
-  }
+/* Pending framebuffer lines, in rendering order */
+static uint16 ntsc_list[NTSC_MAX_LINES];
+static int ntsc_count;
 
-  if((c & 0x0f) == 0x00) c &= 0xC0;
+#ifdef USE_THREADS
+/* Maximal number of threads filtering frame lines (including emulation thread) */
+#define NTSC_MAX_THREADS 4
 
-  return (c);
-}
+/* Minimal number of lines before filtering is shared between threads */
+#define NTSC_MIN_LINES 32
 
-/* Input (bx):  d3-d0=color, d4=palette, d5=priority, d6=zero, d7=sprite pixel marker */
-/* Input (sx):  d3-d0=color, d7-d4=zero */
-/* Output:      d3-d0=color, d4=palette, d5=zero/priority, d6=zero, d7=sprite pixel marker */
-static uint32 make_lut_bgobj_m4(uint32 bx, uint32 sx)
+static struct
 {
-  int c;
-
-  int bf = (bx & 0x3F);
-  int bs = (bx & 0x80);
-  int bp = (bx & 0x20);
-  int b  = (bx & 0x0F);
-
-  int s  = (sx & 0x0F);
-  int sf = (s | 0x10); /* force palette bit */
-
-  /* Transparent sprite pixel */
-  if(s == 0) return bx;
-
-  /* Previous sprite has higher priority */
-  if(bs) return bx;
-
-  /* note: priority bit is always 0 for Modes 0,1,2,3 */
-  c = (bp ? (b ? bf : sf) : sf);
+  mt_thread_t thread[NTSC_MAX_THREADS - 1];
+  mt_mutex_t lock;
+  mt_cond_t start;
+  mt_cond_t done;
+  int workers;                    /* number of started worker threads */
+  int threads;                    /* number of threads filtering current frame */
+  int pending;                    /* number of workers still filtering current frame */
+  uint32 job;                     /* current job index */
+  int quit;
+} ntsc_pool;
+#endif
+#endif
 
-  return (c | 0x80);
-}
+/* Function pointers */
+void (*render_bg)(int line);
+void (*render_obj)(int line);
+void (*parse_satb)(int line);
+void (*update_bg_pattern_cache)(int index);
 
 
 /*--------------------------------------------------------------------------*/
 /* Pixel layer merging function                                             */
 /*--------------------------------------------------------------------------*/
 
-INLINE void merge(uint8 *srca, uint8 *srcb, uint8 *dst, uint8 *table, int width)
+INLINE void merge(uint8 *srca, uint8 *srcb, uint8 *dst, const uint8 *table, int width)
 {
   do
   {
@@ -1097,6 +947,8 @@ static void palette_init(void)
 
 void color_update_m4(int index, unsigned int data)
 {
+  color_serial++;
+
   switch (system_hw)
   {
     case SYSTEM_GG:
@@ -1199,6 +1051,8 @@ void color_update_m4(int index, unsigned int data)
 
 void color_update_m5(int index, unsigned int data)
 {
+  color_serial++;
+
   /* Palette Mode */
   if (!(reg[0] & 0x04))
   {
@@ -1584,6 +1438,9 @@ void render_bg_m4(int line)
 }
 
 /* Mode 5 */
+/* Pattern attributes are decoded from name table for each column: this     */
+/* only costs a few shifts & one table lookup, which is not slower than     */
+/* reading back decoded attributes from a name table row cache.             */
 #ifndef ALT_RENDERER
 void render_bg_m5(int line)
 {
@@ -2578,7 +2435,7 @@ void render_bg_m5(int line)
   int width = bitmap.viewport.w >> 4;
 
   /* Layer priority table */
-  uint8 *table = lut[(reg[12] & 8) >> 2];
+  const uint8 *table = lut[(reg[12] & 8) >> 2];
 
   /* Window vertical range (cell 0-31) */
   int a = (reg[18] & 0x1F) << 3;
@@ -2736,7 +2593,7 @@ void render_bg_m5_vs(int line)
   int width = bitmap.viewport.w >> 4;
 
   /* Layer priority table */
-  uint8 *table = lut[(reg[12] & 8) >> 2];
+  const uint8 *table = lut[(reg[12] & 8) >> 2];
 
   /* Window vertical range (cell 0-31) */
   int a = (reg[18] & 0x1F) << 3;
@@ -2933,7 +2790,7 @@ void render_bg_m5_vs_enhanced(int line)
   int width = bitmap.viewport.w >> 4;
 
   /* Layer priority table */
-  uint8 *table = lut[(reg[12] & 8) >> 2];
+  const uint8 *table = lut[(reg[12] & 8) >> 2];
 
   /* Window vertical range (cell 0-31) */
   int a = (reg[18] & 0x1F) << 3;
@@ -3269,7 +3126,7 @@ void render_bg_m5_im2(int line)
   int width = bitmap.viewport.w >> 4;
 
   /* Layer priority table */
-  uint8 *table = lut[(reg[12] & 8) >> 2];
+  const uint8 *table = lut[(reg[12] & 8) >> 2];
 
   /* Window vertical range (cell 0-31) */
   int a = (reg[18] & 0x1F) << 3;
@@ -3428,7 +3285,7 @@ void render_bg_m5_im2_vs(int line)
   int width = bitmap.viewport.w >> 4;
 
   /* Layer priority table */
-  uint8 *table = lut[(reg[12] & 8) >> 2];
+  const uint8 *table = lut[(reg[12] & 8) >> 2];
 
   /* Window vertical range (cell 0-31) */
   uint32 a = (reg[18] & 0x1F) << 3;
@@ -3866,7 +3723,8 @@ void render_obj_m5(int line)
   int masked = 0;
   int max_pixels = MODE5_MAX_SPRITE_PIXELS;
 
-  uint8 *src, *s, *lb;
+  uint8 *src, *lb;
+  const uint8 *s;
   uint32 temp, v_line;
   uint32 attr, name, atex;
 
@@ -3944,8 +3802,7 @@ void render_obj_m5(int line)
       /* Draw sprite patterns */
       for (column = 0; column < width; column++, lb+=8)
       {
-        temp = attr | ((name + s[column]) & 0x07FF);
-        src = &bg_pattern_cache[(temp << 6) | (v_line)];
+        GET_SPRITE_TILE(attr, (name + s[column]) & 0x07FF, v_line)
         DRAW_SPRITE_TILE(8,atex,lut[1])
       }
     }
@@ -3976,7 +3833,8 @@ void render_obj_m5_ste(int line)
   int masked = 0;
   int max_pixels = MODE5_MAX_SPRITE_PIXELS;
 
-  uint8 *src, *s, *lb;
+  uint8 *src, *lb;
+  const uint8 *s;
   uint32 temp, v_line;
   uint32 attr, name, atex;
 
@@ -4056,8 +3914,7 @@ void render_obj_m5_ste(int line)
       /* Draw sprite patterns */
       for (column = 0; column < width; column++, lb+=8)
       {
-        temp = attr | ((name + s[column]) & 0x07FF);
-        src = &bg_pattern_cache[(temp << 6) | (v_line)];
+        GET_SPRITE_TILE(attr, (name + s[column]) & 0x07FF, v_line)
         DRAW_SPRITE_TILE(8,atex,lut[3])
       }
     }
@@ -4095,7 +3952,8 @@ void render_obj_m5_im2(int line)
   int odd = odd_frame;
   int max_pixels = MODE5_MAX_SPRITE_PIXELS;
 
-  uint8 *src, *s, *lb;
+  uint8 *src, *lb;
+  const uint8 *s;
   uint32 temp, v_line;
   uint32 attr, name, atex;
 
@@ -4172,8 +4030,7 @@ void render_obj_m5_im2(int line)
       /* Render sprite patterns */
       for(column = 0; column < width; column ++, lb+=8)
       {
-        temp = attr | (((name + s[column]) & 0x3ff) << 1);
-        src = &bg_pattern_cache[((temp << 6) | (v_line)) ^ ((attr & 0x1000) >> 6)];
+        GET_SPRITE_TILE_IM2(attr, ((name + s[column]) & 0x3ff) << 1, v_line)
         DRAW_SPRITE_TILE(8,atex,lut[1])
       }
     }
@@ -4205,7 +4062,8 @@ void render_obj_m5_im2_ste(int line)
   int odd = odd_frame;
   int max_pixels = MODE5_MAX_SPRITE_PIXELS;
 
-  uint8 *src, *s, *lb;
+  uint8 *src, *lb;
+  const uint8 *s;
   uint32 temp, v_line;
   uint32 attr, name, atex;
 
@@ -4285,8 +4143,7 @@ void render_obj_m5_im2_ste(int line)
       /* Render sprite patterns */
       for(column = 0; column < width; column ++, lb+=8)
       {
-        temp = attr | (((name + s[column]) & 0x3ff) << 1);
-        src = &bg_pattern_cache[((temp << 6) | (v_line)) ^ ((attr & 0x1000) >> 6)];
+        GET_SPRITE_TILE_IM2(attr, ((name + s[column]) & 0x3ff) << 1, v_line)
         DRAW_SPRITE_TILE(8,atex,lut[3])
       }
     }
@@ -4497,13 +4354,14 @@ void parse_satb_m4(int line)
   object_count[(line + 1) & 1] = count;
 }
 
-void parse_satb_m5(int line)
+/* Walk internal SAT link list once and sort parsed entries by line */
+static void sprite_index_update(void)
 {
   /* Y position */
   int ypos;
 
-  /* Sprite height (8,16,24,32 pixels)*/
-  int height;
+  /* Last line */
+  int end;
 
   /* Sprite size data */
   int size;
@@ -4511,67 +4369,34 @@ void parse_satb_m5(int line)
   /* Sprite link data */
   int link = 0;
 
-  /* Sprite counter */
-  int count = 0;
-
-  /* max. number of rendered sprites (16 or 20 sprites per line by default) */
-  int max = MODE5_MAX_SPRITES_PER_LINE;
+  /* Parsed entry index */
+  int n = 0;
 
   /* max. number of parsed sprites (64 or 80 sprites per line by default) */
   int total = max_sprite_pixels >> 2;
 
-  /* Pointer to sprite attribute table */
-  uint16 *p = (uint16 *) &vram[satb];
-
   /* Pointer to internal RAM */
   uint16 *q = (uint16 *) &sat[0];
 
-  /* Sprite list for next line */
-  object_info_t *object_info = obj_info[(line + 1) & 1];
-
-  /* Adjust line offset */
-  line += 0x81;
+  memset(sprite_index.count, 0, sizeof(sprite_index.count));
 
   do
   {
-    /* Read Y position from internal SAT cache */
+    /* Read Y position & sprite size from internal SAT cache */
     ypos = (q[link] >> im2_flag) & 0x1FF;
+    size = q[link + 1] >> 8;
 
-    /* Check if sprite Y position has been reached */
-    if (line >= ypos)
-    {
-      /* Read sprite size from internal SAT cache */
-      size = q[link + 1] >> 8;
-
-      /* Sprite height */
-      height = 8 + ((size & 3) << 3);
-
-      /* Y range */
-      ypos = line - ypos;
-
-      /* Check if sprite is visible on current line */
-      if (ypos < height)
-      {
-        /* Sprite overflow */
-        if (count == max)
-        {
-          status |= 0x40;
-          break;
-        }
-
-        /* Update sprite list (only name, attribute & xpos are parsed from VRAM) */
-        object_info->attr  = p[link + 2];
-        object_info->xpos  = p[link + 3] & 0x1ff;
-        object_info->ypos  = ypos;
-        object_info->size  = size & 0x0f;
-
-        /* Increment Sprite count */
-        ++count;
+    sprite_index.entry[n].link = link;
+    sprite_index.entry[n].ypos = ypos;
+    sprite_index.entry[n].size = size & 0x0f;
 
-        /* Next sprite entry */
-        object_info++;
-      }
+    /* Add entry to each line covered by sprite height (8,16,24,32 pixels) */
+    end = ypos + 8 + ((size & 3) << 3);
+    for (; ypos < end; ypos++)
+    {
+      sprite_index.list[ypos][sprite_index.count[ypos]++] = n;
     }
+    n++;
 
     /* Read link data from internal SAT cache */
     link = (q[link + 1] & 0x7F) << 2;
@@ -4581,60 +4406,198 @@ void parse_satb_m5(int line)
   }
   while (--total);
 
-  /* Update sprite count for next line (line value already incremented) */
-  object_count[line & 1] = count;
+  sprite_index.width = bitmap.viewport.w;
+  sprite_index.total = max_sprite_pixels >> 2;
+  sprite_index.im2 = im2_flag;
+  sat_dirty = 0;
 }
 
-
-/*--------------------------------------------------------------------------*/
-/* Pattern cache update function                                            */
-/*--------------------------------------------------------------------------*/
-
-void update_bg_pattern_cache_m4(int index)
+void parse_satb_m5(int line)
 {
-  int i;
-  uint8 x, y, c;
-  uint8 *dst;
-  uint16 name, bp01, bp23;
-  uint32 bp;
-
-  for(i = 0; i < index; i++)
-  {
-    /* Get modified pattern name index */
-    name = bg_name_list[i];
+  /* Sprite counter */
+  int count = 0;
 
-    /* Pattern cache base address */
-    dst = &bg_pattern_cache[name << 6];
+  /* max. number of rendered sprites (16 or 20 sprites per line by default) */
+  int max = MODE5_MAX_SPRITES_PER_LINE;
 
-    /* Check modified lines */
-    for(y = 0; y < 8; y++)
+  /* Pointer to sprite attribute table */
+  uint16 *p = (uint16 *) &vram[satb];
+
+  /* Sprite list for next line */
+  object_info_t *object_info = obj_info[(line + 1) & 1];
+
+  /* Adjust line offset */
+  line += 0x81;
+
+  /* Rebuild sprite index if internal SAT or parsing parameters have changed */
+  if (sat_dirty || (sprite_index.width != bitmap.viewport.w) ||
+      (sprite_index.total != (max_sprite_pixels >> 2)) || (sprite_index.im2 != im2_flag))
+  {
+    sprite_index_update();
+  }
+
+  if ((unsigned int)line < SPRITE_INDEX_LINES)
+  {
+    /* Parsed entries visible on current line, in link order */
+    uint8 *list = sprite_index.list[line];
+    int i, num = sprite_index.count[line];
+
+    for (i = 0; i < num; i++)
     {
-      if(bg_name_dirty[name] & (1 << y))
+      sprite_entry_t *entry = &sprite_index.entry[list[i]];
+
+      /* Sprite overflow */
+      if (count == max)
       {
-        /* Byteplane data */
-        bp01 = *(uint16 *)&vram[(name << 5) | (y << 2) | (0)];
-        bp23 = *(uint16 *)&vram[(name << 5) | (y << 2) | (2)];
+        status |= 0x40;
+        break;
+      }
+
+      /* Update sprite list (only name, attribute & xpos are parsed from VRAM) */
+      object_info->attr  = p[entry->link + 2];
+      object_info->xpos  = p[entry->link + 3] & 0x1ff;
+      object_info->ypos  = line - entry->ypos;
+      object_info->size  = entry->size;
+
+      /* Increment Sprite count */
+      ++count;
+
+      /* Next sprite entry */
+      object_info++;
+    }
+  }
+
+  /* Update sprite count for next line (line value already incremented) */
+  object_count[line & 1] = count;
+}
+
+
+/*--------------------------------------------------------------------------*/
+/* Pattern cache update function                                            */
+/*--------------------------------------------------------------------------*/
+
+/* Expand 4 packed pixels to 4 bytes */
+/* (msb) p3 p2 p1 p0 (lsb) -> (msb) 0p3 0p2 0p1 0p0 (lsb) */
+INLINE uint32 unpack_pixels(uint32 x)
+{
+  x = (x | (x << 8)) & 0x00FF00FF;
+  return (x | (x << 4)) & 0x0F0F0F0F;
+}
+
+/* Expand 4 bits from each byteplane to 4 bytes */
+/* byte n = (msb) 0000 bp3[n] bp2[n] bp1[n] bp0[n] (lsb) */
+INLINE uint32 unpack_bitplanes(uint32 bp0, uint32 bp1, uint32 bp2, uint32 bp3)
+{
+  bp0 = (bp0 | (bp0 << 14)) & 0x00030003;
+  bp1 = (bp1 | (bp1 << 14)) & 0x00030003;
+  bp2 = (bp2 | (bp2 << 14)) & 0x00030003;
+  bp3 = (bp3 | (bp3 << 14)) & 0x00030003;
+  bp0 = (bp0 | (bp0 << 7)) & 0x01010101;
+  bp1 = (bp1 | (bp1 << 7)) & 0x01010101;
+  bp2 = (bp2 | (bp2 << 7)) & 0x01010101;
+  bp3 = (bp3 | (bp3 << 7)) & 0x01010101;
+  return bp0 | (bp1 << 1) | (bp2 << 2) | (bp3 << 3);
+}
+
+/* Update one Mode 4 cached pattern line (8 pixels = 8 bytes = two 32-bit writes per pattern) */
+INLINE void update_line_m4(uint32 *dst, const uint8 *src, int y)
+{
+  uint32 hi, lo, w0, w1;
+
+  /* Byteplanes data (one pattern line = 4 bytes) */
+  /* pixel 0: c3 = bp3 bit 7, c2 = bp2 bit 7, c1 = bp1 bit 7, c0 = bp0 bit 7  */
+  /* ...                                                                      */
+  /* pixel 7: c3 = bp3 bit 0, c2 = bp2 bit 0, c1 = bp1 bit 0, c0 = bp0 bit 0  */
+  src += (y << 2);
+
+  /* (msb) p0 p1 p2 p3 (lsb) */
+  hi = unpack_bitplanes(src[0] >> 4, src[1] >> 4, src[2] >> 4, src[3] >> 4);
+
+  /* (msb) p4 p5 p6 p7 (lsb) */
+  lo = unpack_bitplanes(src[0] & 0x0F, src[1] & 0x0F, src[2] & 0x0F, src[3] & 0x0F);
+
+  /* byte0 <-> p0 p1 p2 p3 p4 p5 p6 p7 <-> byte7 (hflip = 0) */
+#ifdef LSB_FIRST
+  w0 = HFLIP_LONG(hi);
+  w1 = HFLIP_LONG(lo);
+#else
+  w0 = hi;
+  w1 = lo;
+#endif
+
+  dst[0x0000 | (y << 1)] = w0;                        /* vflip=0 & hflip=0 */
+  dst[0x0001 | (y << 1)] = w1;
+  dst[0x2000 | (y << 1)] = HFLIP_LONG(w1);            /* vflip=0 & hflip=1 */
+  dst[0x2001 | (y << 1)] = HFLIP_LONG(w0);
+  dst[0x4000 | ((y ^ 7) << 1)] = w0;                  /* vflip=1 & hflip=0 */
+  dst[0x4001 | ((y ^ 7) << 1)] = w1;
+  dst[0x6000 | ((y ^ 7) << 1)] = HFLIP_LONG(w1);      /* vflip=1 & hflip=1 */
+  dst[0x6001 | ((y ^ 7) << 1)] = HFLIP_LONG(w0);
+}
+
+/* Update one Mode 5 cached pattern line (8 pixels = 8 bytes = two 32-bit writes per pattern) */
+INLINE void update_line_m5(uint32 *dst, uint32 bp, int y)
+{
+  uint32 w0, w1;
+
+  /* byte0 <-> p0 p1 p2 p3 p4 p5 p6 p7 <-> byte7 (hflip = 0) */
+#ifdef LSB_FIRST
+  /* Byteplane data = (msb) p4p5 p6p7 p0p1 p2p3 (lsb) */
+  w0 = HFLIP_LONG(unpack_pixels(bp & 0xFFFF));
+  w1 = HFLIP_LONG(unpack_pixels(bp >> 16));
+#else
+  /* Byteplane data = (msb) p0p1 p2p3 p4p5 p6p7 (lsb) */
+  w0 = unpack_pixels(bp >> 16);
+  w1 = unpack_pixels(bp & 0xFFFF);
+#endif
+
+  dst[0x00000 | (y << 1)] = w0;                       /* vflip=0, hflip=0 */
+  dst[0x00001 | (y << 1)] = w1;
+#ifndef USE_COMPACT_PATTERN_CACHE
+  dst[0x08000 | (y << 1)] = HFLIP_LONG(w1);           /* vflip=0, hflip=1 */
+  dst[0x08001 | (y << 1)] = HFLIP_LONG(w0);
+  dst[0x10000 | ((y ^ 7) << 1)] = w0;                 /* vflip=1, hflip=0 */
+  dst[0x10001 | ((y ^ 7) << 1)] = w1;
+  dst[0x18000 | ((y ^ 7) << 1)] = HFLIP_LONG(w1);     /* vflip=1, hflip=1 */
+  dst[0x18001 | ((y ^ 7) << 1)] = HFLIP_LONG(w0);
+#endif
+}
+
+void update_bg_pattern_cache_m4(int index)
+{
+  int i, y;
+  uint8 dirty;
+  uint8 *src;
+  uint32 *dst;
+  uint16 name;
+
+  for(i = 0; i < index; i++)
+  {
+    /* Get modified pattern name index */
+    name = bg_name_list[i];
+
+    /* Pattern data & pattern cache base addresses */
+    src = &vram[name << 5];
+    dst = (uint32 *)&bg_pattern_cache[name << 6];
 
-        /* Convert to pixel line data (4 bytes = 8 pixels)*/
-        /* (msb) p7p6 p5p4 p3p2 p1p0 (lsb) */
-        bp = (bp_lut[bp01] >> 2) | (bp_lut[bp23]);
+    /* Modified lines */
+    dirty = bg_name_dirty[name];
 
-        /* Update cached line (8 pixels = 8 bytes) */
-        for(x = 0; x < 8; x++)
+    if (dirty == 0xFF)
+    {
+      /* All lines modified (no branch in loop, so it can be vectorized) */
+      for(y = 0; y < 8; y++)
+      {
+        update_line_m4(dst, src, y);
+      }
+    }
+    else
+    {
+      for(y = 0; y < 8; y++)
+      {
+        if(dirty & (1 << y))
         {
-          /* Extract pixel data */
-          c = bp & 0x0F;
-
-          /* Pattern cache data (one pattern = 8 bytes) */
-          /* byte0 <-> p0 p1 p2 p3 p4 p5 p6 p7 <-> byte7 (hflip = 0) */
-          /* byte0 <-> p7 p6 p5 p4 p3 p2 p1 p0 <-> byte7 (hflip = 1) */
-          dst[0x00000 | (y << 3) | (x)] = (c);            /* vflip=0 & hflip=0 */
-          dst[0x08000 | (y << 3) | (x ^ 7)] = (c);        /* vflip=0 & hflip=1 */
-          dst[0x10000 | ((y ^ 7) << 3) | (x)] = (c);      /* vflip=1 & hflip=0 */
-          dst[0x18000 | ((y ^ 7) << 3) | (x ^ 7)] = (c);  /* vflip=1 & hflip=1 */
-
-          /* Next pixel */
-          bp = bp >> 4;
+          update_line_m4(dst, src, y);
         }
       }
     }
@@ -4646,54 +4609,38 @@ void update_bg_pattern_cache_m4(int index)
 
 void update_bg_pattern_cache_m5(int index)
 {
-  int i;
-  uint8 x, y, c;
-  uint8 *dst;
+  int i, y;
+  uint8 dirty;
+  uint32 *src, *dst;
   uint16 name;
-  uint32 bp;
 
   for(i = 0; i < index; i++)
   {
     /* Get modified pattern name index */
     name = bg_name_list[i];
 
-    /* Pattern cache base address */
-    dst = &bg_pattern_cache[name << 6];
+    /* Pattern data & pattern cache base addresses */
+    src = (uint32 *)&vram[name << 5];
+    dst = (uint32 *)&bg_pattern_cache[name << 6];
 
-    /* Check modified lines */
-    for(y = 0; y < 8; y ++)
+    /* Modified lines */
+    dirty = bg_name_dirty[name];
+
+    if (dirty == 0xFF)
     {
-      if(bg_name_dirty[name] & (1 << y))
+      /* All lines modified (no branch in loop, so it can be vectorized) */
+      for(y = 0; y < 8; y++)
       {
-        /* Byteplane data (one pattern = 4 bytes) */
-        /* LIT_ENDIAN: byte0 (lsb) p2p3 p0p1 p6p7 p4p5 (msb) byte3 */
-        /* BIG_ENDIAN: byte0 (msb) p0p1 p2p3 p4p5 p6p7 (lsb) byte3 */
-        bp = *(uint32 *)&vram[(name << 5) | (y << 2)];
-
-        /* Update cached line (8 pixels = 8 bytes) */
-        for(x = 0; x < 8; x ++)
+        update_line_m5(dst, src[y], y);
+      }
+    }
+    else
+    {
+      for(y = 0; y < 8; y++)
+      {
+        if(dirty & (1 << y))
         {
-          /* Extract pixel data */
-          c = bp & 0x0F;
-
-          /* Pattern cache data (one pattern = 8 bytes) */
-          /* byte0 <-> p0 p1 p2 p3 p4 p5 p6 p7 <-> byte7 (hflip = 0) */
-          /* byte0 <-> p7 p6 p5 p4 p3 p2 p1 p0 <-> byte7 (hflip = 1) */
-#ifdef LSB_FIRST
-          /* Byteplane data = (msb) p4p5 p6p7 p0p1 p2p3 (lsb) */
-          dst[0x00000 | (y << 3) | (x ^ 3)] = (c);        /* vflip=0, hflip=0 */
-          dst[0x20000 | (y << 3) | (x ^ 4)] = (c);        /* vflip=0, hflip=1 */
-          dst[0x40000 | ((y ^ 7) << 3) | (x ^ 3)] = (c);  /* vflip=1, hflip=0 */
-          dst[0x60000 | ((y ^ 7) << 3) | (x ^ 4)] = (c);  /* vflip=1, hflip=1 */
-#else
-          /* Byteplane data = (msb) p0p1 p2p3 p4p5 p6p7 (lsb) */
-          dst[0x00000 | (y << 3) | (x ^ 7)] = (c);        /* vflip=0, hflip=0 */
-          dst[0x20000 | (y << 3) | (x)] = (c);            /* vflip=0, hflip=1 */
-          dst[0x40000 | ((y ^ 7) << 3) | (x ^ 7)] = (c);  /* vflip=1, hflip=0 */
-          dst[0x60000 | ((y ^ 7) << 3) | (x)] = (c);      /* vflip=1, hflip=1 */
-#endif
-          /* Next pixel */
-          bp = bp >> 4;
+          update_line_m5(dst, src[y], y);
         }
       }
     }
@@ -4759,33 +4706,16 @@ void window_clip(unsigned int data, unsigned int sw)
 
 void render_init(void)
 {
-  int bx, ax;
-
+#ifndef USE_STATIC_LUTS
   /* Initialize layers priority pixel look-up tables */
-  uint16 index;
-  for (bx = 0; bx < 0x100; bx++)
-  {
-    for (ax = 0; ax < 0x100; ax++)
-    {
-      index = (bx << 8) | (ax);
-
-      lut[0][index] = make_lut_bg(bx, ax);
-      lut[1][index] = make_lut_bgobj(bx, ax);
-      lut[2][index] = make_lut_bg_ste(bx, ax);
-      lut[3][index] = make_lut_obj(bx, ax);
-      lut[4][index] = make_lut_bgobj_ste(bx, ax);
-      lut[5][index] = make_lut_bgobj_m4(bx,ax);
-    }
-  }
-
-  /* Initialize pixel color look-up tables */
-  palette_init();
+  make_lut(lut);
 
   /* Make sprite pattern name index look-up table (Mode 5) */
-  make_name_lut();
+  make_name_lut(name_lut);
+#endif
 
-  /* Make bitplane to pixel look-up table (Mode 4) */
-  make_bp_lut();
+  /* Initialize pixel color look-up tables */
+  palette_init();
 }
 
 void render_reset(void)
@@ -4807,6 +4737,42 @@ void render_reset(void)
 
   /* Reset Sprite infos */
   spr_ovr = spr_col = object_count[0] = object_count[1] = 0;
+
+  /* Invalidate line cache */
+  memset(line_cache, 0, sizeof(line_cache));
+}
+
+void render_shutdown(void)
+{
+#ifdef NTSC_FRAME_FILTER
+#ifdef USE_THREADS
+  int i;
+
+  if (ntsc_pool.workers > 0)
+  {
+    mt_mutex_lock(&ntsc_pool.lock);
+    ntsc_pool.quit = 1;
+    mt_cond_broadcast(&ntsc_pool.start);
+    mt_mutex_unlock(&ntsc_pool.lock);
+
+    for (i=0; i<ntsc_pool.workers; i++)
+    {
+      mt_thread_join(ntsc_pool.thread[i]);
+    }
+
+    mt_cond_destroy(&ntsc_pool.done);
+    mt_cond_destroy(&ntsc_pool.start);
+    mt_mutex_destroy(&ntsc_pool.lock);
+  }
+
+  ntsc_pool.workers = 0;
+#endif
+
+  free(ntsc_buf);
+  ntsc_buf = NULL;
+  memset(ntsc_line, 0, sizeof(ntsc_line));
+  ntsc_count = 0;
+#endif
 }
 
 
@@ -4814,8 +4780,92 @@ void render_reset(void)
 /* Line rendering functions                                                 */
 /*--------------------------------------------------------------------------*/
 
+#ifdef NTSC_FRAME_FILTER
+static void ntsc_blit_line(const PIXEL_OUT_T *src, int width, int md, PIXEL_OUT_T border, int line)
+{
+  void *dst = &bitmap.data[line * bitmap.pitch];
+
+  if (md)
+  {
+    md_ntsc_blit_row(md_ntsc, src, border, width, dst);
+  }
+  else
+  {
+    sms_ntsc_blit_row(sms_ntsc, src, border, width, dst);
+  }
+}
+#endif
+
+/* Framebuffer line (-1 if line is not displayed) */
+static int output_line(int line)
+{
+  /* Adjust line offset in framebuffer */
+  line = (line + bitmap.viewport.y) % lines_per_frame;
+
+  /* Take care of Game Gear reduced screen when overscan is disabled */
+  if (line < 0) return -1;
+
+  /* Adjust for interlaced output */
+  if (interlaced && config.render)
+  {
+    line = (line * 2) + odd_frame;
+  }
+
+  return line;
+}
+
+/* Everything rendered line depends on, except VRAM & color palette (returns key size in bytes) */
+static uint32 line_cache_key(int line, uint32 *key)
+{
+  int i;
+  object_info_t *object_info = obj_info[line & 1];
+  int count = object_count[line & 1];
+  uint32 *start = key;
+
+  /* Registers (except H-Int counter, auto-increment & DMA registers) */
+  *key++ = reg[0] | (reg[1] << 8) | (reg[2] << 16) | (reg[3] << 24);
+  *key++ = reg[4] | (reg[5] << 8) | (reg[6] << 16) | (reg[7] << 24);
+  *key++ = reg[8] | (reg[9] << 8) | (reg[11] << 16) | (reg[12] << 24);
+  *key++ = reg[13] | (reg[14] << 8) | (reg[16] << 16) | (reg[17] << 24);
+  *key++ = reg[18] | (odd_frame << 8) | (spr_ovr << 16) | (count << 24);
+
+  /* Line position & viewport */
+  *key++ = line | (bitmap.viewport.y << 16);
+  *key++ = bitmap.viewport.x | (bitmap.viewport.w << 16);
+  *key++ = max_sprite_pixels | (config.ntsc << 16) | (config.render << 24);
+  *key++ = config.enhanced_vscroll | (config.enhanced_vscroll_limit << 8) | (im2_flag << 16);
+
+  /* Vertical scroll */
+  for (i = 0; i < 0x50; i += 4)
+  {
+    *key++ = *(uint16 *)&vsram[i] | (*(uint16 *)&vsram[i + 2] << 16);
+  }
+
+  /* Sprites on current line */
+  while (count--)
+  {
+    *key++ = object_info->ypos | (object_info->xpos << 16);
+    *key++ = object_info->attr | (object_info->size << 16);
+    object_info++;
+  }
+
+  return (key - start) * sizeof(uint32);
+}
+
+/* Invalidate line cache (framebuffer was modified outside of VDP rendering) */
+void render_line_cache_reset(void)
+{
+  memset(line_cache, 0, sizeof(line_cache));
+}
+
 void render_line(int line)
 {
+  /* Line cache entry */
+  line_cache_t *cache = NULL;
+  uint32 key[LINE_CACHE_KEY];
+  uint32 size = 0;
+  int width = bitmap.viewport.w + 2*bitmap.viewport.x;
+
   /* Check display status */
   if (reg[1] & 0x40)
   {
@@ -4824,6 +4874,46 @@ void render_line(int line)
     {
       update_bg_pattern_cache(bg_list_index);
       bg_list_index = 0;
+      vram_serial++;
+    }
+
+    /* Line cache (Mode 5 only, LCD ghosting depends on previous frame, lightgun cursor is drawn over framebuffer) */
+    if (config.line_cache && !config.lcd && !config.gun_cursor && (parse_satb == parse_satb_m5) && (width <= LINE_CACHE_WIDTH))
+    {
+      int index = output_line(line);
+
+      /* Rendering mode changed (interlaced modes are only updated on next frame) */
+      if ((render_bg != line_cache_bg) || (render_obj != line_cache_obj))
+      {
+        memset(line_cache, 0, sizeof(line_cache));
+        line_cache_bg = render_bg;
+        line_cache_obj = render_obj;
+      }
+
+      if ((index >= 0) && (index < LINE_CACHE_LINES))
+      {
+        cache = &line_cache[index];
+        size = line_cache_key(line, key);
+
+        /* Framebuffer line is up to date if nothing changed since it was rendered */
+        if (cache->valid && (cache->vram == vram_serial) && (cache->color == color_serial) && (cache->size == size) && !memcmp(cache->key, key, size))
+        {
+          /* Restore line buffer (mid-line palette changes remap it again) */
+          memcpy(&linebuf[0][0x20 - bitmap.viewport.x], line_cache_buf[index], width);
+
+          /* Sprite masking flag for next line */
+          spr_ovr = cache->spr_ovr;
+
+          /* Parse sprites for next line */
+          if (line < (bitmap.viewport.h - 1))
+          {
+            parse_satb(line);
+          }
+
+          render_skipped_lines++;
+          return;
+        }
+      }
     }
 
     /* Render BG layer(s) */
@@ -4832,6 +4922,12 @@ void render_line(int line)
     /* Render sprite layer */
     render_obj(line & 1);
 
+    /* Sprite masking flag for next line */
+    if (cache)
+    {
+      cache->spr_ovr = spr_ovr;
+    }
+
     /* Left-most column blanking */
     if (reg[0] & 0x20)
     {
@@ -4873,6 +4969,17 @@ void render_line(int line)
 
   /* Pixel color remapping */
   remap_line(line);
+
+  /* Update line cache (lines with sprite collision are always rendered) */
+  if (cache && !(status & 0x20))
+  {
+    cache->valid = 1;
+    cache->size = size;
+    memcpy(cache->key, key, size);
+    cache->vram = vram_serial;
+    cache->color = color_serial;
+    memcpy(line_cache_buf[cache - line_cache], &linebuf[0][0x20 - bitmap.viewport.x], width);
+  }
 }
 
 void blank_line(int line, int offset, int width)
@@ -4889,22 +4996,50 @@ void remap_line(int line)
   /* Pixel line buffer */
   uint8 *src = &linebuf[0][0x20 - bitmap.viewport.x];
 
-  /* Adjust line offset in framebuffer */
-  line = (line + bitmap.viewport.y) % lines_per_frame;
-
-  /* Take care of Game Gear reduced screen when overscan is disabled */
+  /* Line offset in framebuffer */
+  line = output_line(line);
   if (line < 0) return;
 
-  /* Adjust for interlaced output */
-  if (interlaced && config.render)
+  /* Framebuffer line is modified */
+  if (line < LINE_CACHE_LINES)
   {
-    line = (line * 2) + odd_frame;
+    line_cache[line].valid = 0;
   }
 
-#if defined(USE_15BPP_RENDERING) || defined(USE_16BPP_RENDERING)
-  /* NTSC Filter (only supported for 15 or 16-bit pixels rendering) */
+#if !defined(USE_8BPP_RENDERING)
+  /* NTSC Filter (only supported for 15, 16 or 32-bit pixels rendering) */
   if (config.ntsc)
   {
+#ifdef NTSC_FRAME_FILTER
+    if ((line < NTSC_MAX_LINES) && (ntsc_buf || (ntsc_buf = malloc(NTSC_MAX_LINES * NTSC_MAX_WIDTH * sizeof(PIXEL_OUT_T)))))
+    {
+      /* Convert VDP pixel data, line is filtered at the end of the frame */
+      PIXEL_OUT_T *dst = &ntsc_buf[line * NTSC_MAX_WIDTH];
+      if (!ntsc_line[line].width)
+      {
+        ntsc_list[ntsc_count++] = line;
+      }
+      ntsc_line[line].width = width;
+      ntsc_line[line].md = reg[12] & 0x01;
+      ntsc_line[line].border = pixel[0];
+      do
+      {
+        *dst++ = pixel[*src++];
+      }
+      while (--width);
+    }
+    else
+    {
+      /* Filter line immediately */
+      PIXEL_OUT_T temp[NTSC_MAX_WIDTH];
+      int i;
+      for (i=0; i<width; i++)
+      {
+        temp[i] = pixel[src[i]];
+      }
+      ntsc_blit_line(temp, width, reg[12] & 0x01, pixel[0], line);
+    }
+#else
     if (reg[12] & 0x01)
     {
       md_ntsc_blit(md_ntsc, ( MD_NTSC_IN_T const * )pixel, src, width, line);
@@ -4913,6 +5048,7 @@ void remap_line(int line)
     {
       sms_ntsc_blit(sms_ntsc, ( SMS_NTSC_IN_T const * )pixel, src, width, line);
     }
+#endif
   }
   else
 #endif
@@ -4941,3 +5077,162 @@ void remap_line(int line)
  #endif
   }
 }
+
+
+/*--------------------------------------------------------------------------*/
+/* NTSC filter (frame post-processing)                                      */
+/*--------------------------------------------------------------------------*/
+
+#ifdef NTSC_FRAME_FILTER
+static void ntsc_filter_lines(int index, int count)
+{
+  /* each thread filters a band of consecutive lines */
+  int i = (ntsc_count * index) / count;
+  int end = (ntsc_count * (index + 1)) / count;
+
+  for (; i < end; i++)
+  {
+    int line = ntsc_list[i];
+    ntsc_blit_line(&ntsc_buf[line * NTSC_MAX_WIDTH], ntsc_line[line].width, ntsc_line[line].md, ntsc_line[line].border, line);
+  }
+}
+
+#ifdef USE_THREADS
+static void ntsc_worker(void *arg)
+{
+  int index = (int)(size_t)arg;
+  uint32 job = 0;
+
+  mt_mutex_lock(&ntsc_pool.lock);
+
+  while (1)
+  {
+    /* wait for next job */
+    while (!ntsc_pool.quit && (ntsc_pool.job == job))
+    {
+      mt_cond_wait(&ntsc_pool.start, &ntsc_pool.lock);
+    }
+
+    if (ntsc_pool.quit)
+    {
+      break;
+    }
+
+    job = ntsc_pool.job;
+
+    mt_mutex_unlock(&ntsc_pool.lock);
+    ntsc_filter_lines(index, ntsc_pool.threads);
+    mt_mutex_lock(&ntsc_pool.lock);
+
+    if (--ntsc_pool.pending == 0)
+    {
+      mt_cond_signal(&ntsc_pool.done);
+    }
+  }
+
+  mt_mutex_unlock(&ntsc_pool.lock);
+}
+
+static int ntsc_pool_init(void)
+{
+  int i, count = mt_cpu_count();
+
+  if (count > NTSC_MAX_THREADS)
+  {
+    count = NTSC_MAX_THREADS;
+  }
+
+  /* single core: filtering is done on emulation thread */
+  if (count < 2)
+  {
+    ntsc_pool.workers = -1;
+    return 0;
+  }
+
+  mt_mutex_init(&ntsc_pool.lock);
+  mt_cond_init(&ntsc_pool.start);
+  mt_cond_init(&ntsc_pool.done);
+  ntsc_pool.job = 0;
+  ntsc_pool.quit = 0;
+
+  for (i=0; i<(count-1); i++)
+  {
+    if (!mt_thread_create(&ntsc_pool.thread[i], ntsc_worker, (void *)(size_t)(i + 1)))
+    {
+      break;
+    }
+  }
+
+  /* no worker thread could be started */
+  if (!i)
+  {
+    mt_cond_destroy(&ntsc_pool.done);
+    mt_cond_destroy(&ntsc_pool.start);
+    mt_mutex_destroy(&ntsc_pool.lock);
+    ntsc_pool.workers = -1;
+    return 0;
+  }
+
+  ntsc_pool.workers = i;
+  return i;
+}
+
+/* filter lines using worker threads, returns only once all lines have been filtered */
+static void ntsc_filter_parallel(void)
+{
+  /* start workers */
+  mt_mutex_lock(&ntsc_pool.lock);
+  ntsc_pool.threads = ntsc_pool.workers + 1;
+  ntsc_pool.pending = ntsc_pool.workers;
+  ntsc_pool.job++;
+  mt_cond_broadcast(&ntsc_pool.start);
+  mt_mutex_unlock(&ntsc_pool.lock);
+
+  /* emulation thread filters its own lines */
+  ntsc_filter_lines(0, ntsc_pool.threads);
+
+  /* wait for all lines to be filtered before framebuffer is output */
+  mt_mutex_lock(&ntsc_pool.lock);
+  while (ntsc_pool.pending)
+  {
+    mt_cond_wait(&ntsc_pool.done, &ntsc_pool.lock);
+  }
+  mt_mutex_unlock(&ntsc_pool.lock);
+}
+#endif
+#endif
+
+void render_end_frame(void)
+{
+#ifdef NTSC_FRAME_FILTER
+  int i;
+
+  if (!ntsc_count)
+  {
+    return;
+  }
+
+  /* filter lines rendered since last frame (skipped if filter has been disabled meanwhile) */
+  if (config.ntsc)
+  {
+#ifdef USE_THREADS
+    if (config.ntsc_threads && (ntsc_count >= NTSC_MIN_LINES) && (ntsc_pool.workers >= 0) &&
+        (ntsc_pool.workers || ntsc_pool_init()))
+    {
+      ntsc_filter_parallel();
+    }
+    else
+#endif
+    {
+      ntsc_filter_lines(0, 1);
+    }
+  }
+
+  /* clear pending lines */
+  for (i=0; i<ntsc_count; i++)
+  {
+    ntsc_line[ntsc_list[i]].width = 0;
+  }
+  ntsc_count = 0;
+#endif
+}
@@ -101,11 +101,15 @@
 
 /* Global variables */
 extern uint16 spr_col;
+extern uint32 render_skipped_lines;
 
 /* Function prototypes */
 extern void render_init(void);
 extern void render_reset(void);
+extern void render_shutdown(void);
+extern void render_end_frame(void);
 extern void render_line(int line);
+extern void render_line_cache_reset(void);
 extern void blank_line(int line, int offset, int width);
 extern void remap_line(int line);
 extern void window_clip(unsigned int data, unsigned int sw);
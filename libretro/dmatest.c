@@ -0,0 +1,280 @@
+/****************************************************************************
+ *  dmatest.c
+ *
+ *  Genesis Plus GX libretro port
+ *
+ *  VRAM Fill & Copy DMA test tool
+ *
+ *  This file is distributed under the same terms as Genesis Plus GX
+ *  (see LICENSE.txt).
+ *
+ ****************************************************************************/
+
+/* This tool is built and run on the host with "make -f Makefile.libretro   */
+/* dmatest". It runs VRAM Fill & Copy DMA through the VDP and checks VRAM,  */
+/* internal SAT and pattern cache update against the original byte per byte */
+/* DMA implementation (odd addresses, 64K address wrap, SAT overlap,        */
+/* overlapping copies and all auto-increment values are covered).           */
+
+#include "shared.h"
+
+/* DMA is processed at once (see vdp_dma_update) */
+extern int fast_dma_hack;
+
+/* Reference VDP state */
+static uint8 ref_vram[0x10000];
+static uint8 ref_sat[0x400];
+static uint8 ref_dirty[0x800];
+static uint16 ref_list[0x800];
+static int ref_index;
+
+/* Reference SAT location */
+static uint16 ref_satb;
+static uint16 ref_base_mask;
+static uint16 ref_addr_mask;
+
+static uint32 seed = 1;
+
+static unsigned int rnd(void)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) & 0x7fff;
+}
+
+static void ref_mark_dirty(unsigned int index)
+{
+  int name = (index >> 5) & 0x7FF;
+  if (ref_dirty[name] == 0)
+  {
+    ref_list[ref_index++] = name;
+  }
+  ref_dirty[name] |= (1 << ((index >> 2) & 7));
+}
+
+/* Byte write to VRAM (original DMA Fill & Copy implementation) */
+static void ref_write_byte(unsigned int index, uint8 data)
+{
+  if ((index & ref_base_mask) == ref_satb)
+  {
+    WRITE_BYTE(ref_sat, (index & ref_addr_mask) ^ 1, data);
+  }
+
+  WRITE_BYTE(ref_vram, index ^ 1, data);
+  ref_mark_dirty(index);
+}
+
+static void ref_fill(unsigned int dst, unsigned int length, unsigned int inc, unsigned int data)
+{
+  /* Data port write (see vdp_bus_w) */
+  unsigned int index = dst & 0xFFFE;
+  uint16 *p = (uint16 *)&ref_vram[index];
+  uint16 word = (dst & 1) ? (((data >> 8) | (data << 8)) & 0xFFFF) : data;
+
+  if ((index & ref_base_mask) == ref_satb)
+  {
+    *(uint16 *)&ref_sat[index & ref_addr_mask] = word;
+  }
+
+  if (*p != word)
+  {
+    *p = word;
+    ref_mark_dirty(index);
+  }
+
+  dst = (dst + inc) & 0xFFFF;
+
+  /* DMA Fill */
+  do
+  {
+    ref_write_byte(dst, data >> 8);
+    dst = (dst + inc) & 0xFFFF;
+  }
+  while (--length);
+}
+
+static void ref_copy(unsigned int src, unsigned int dst, unsigned int length, unsigned int inc)
+{
+  do
+  {
+    ref_write_byte(dst, READ_BYTE(ref_vram, src ^ 1));
+    src = (src + 1) & 0xFFFF;
+    dst = (dst + inc) & 0xFFFF;
+  }
+  while (--length);
+}
+
+static void vdp_reg(unsigned int r, unsigned int d)
+{
+  vdp_68k_ctrl_w(0x8000 | (r << 8) | d);
+}
+
+static void vdp_fill(unsigned int dst, unsigned int length, unsigned int inc, unsigned int data)
+{
+  vdp_reg(15, inc);
+  vdp_reg(19, length & 0xFF);
+  vdp_reg(20, (length >> 8) & 0xFF);
+  vdp_reg(23, 0x80);
+  vdp_68k_ctrl_w(0x4000 | (dst & 0x3FFF));
+  vdp_68k_ctrl_w(0x0080 | (dst >> 14));
+  vdp_68k_data_w(data);
+}
+
+static void vdp_copy(unsigned int src, unsigned int dst, unsigned int length, unsigned int inc)
+{
+  vdp_reg(15, inc);
+  vdp_reg(19, length & 0xFF);
+  vdp_reg(20, (length >> 8) & 0xFF);
+  vdp_reg(21, src & 0xFF);
+  vdp_reg(22, (src >> 8) & 0xFF);
+  vdp_reg(23, 0xC0);
+  vdp_68k_ctrl_w(dst & 0x3FFF);
+  vdp_68k_ctrl_w(0x00C0 | (dst >> 14));
+}
+
+/* Randomize VRAM, resynchronize internal SAT and clear pattern cache update list */
+static void prepare(int h40)
+{
+  int i;
+
+  /* Display width & SAT address (H32 SAT is located at end of VRAM to test address wrap) */
+  vdp_reg(12, h40 ? 0x81 : 0x00);
+  vdp_reg(5, h40 ? 0x6C : 0x7F);
+  ref_satb = h40 ? 0xD800 : 0xFE00;
+  ref_base_mask = h40 ? 0xFC00 : 0xFE00;
+  ref_addr_mask = h40 ? 0x03FF : 0x01FF;
+
+  for (i = 0; i < 0x10000; i++)
+  {
+    vram[i] = rnd();
+  }
+
+  memset(sat, 0, sizeof(sat));
+  memcpy(sat, &vram[ref_satb], ref_addr_mask + 1);
+
+  for (i = 0; i < bg_list_index; i++)
+  {
+    bg_name_dirty[bg_name_list[i]] = 0;
+  }
+  bg_list_index = 0;
+
+  memcpy(ref_vram, vram, sizeof(ref_vram));
+  memcpy(ref_sat, sat, sizeof(ref_sat));
+  memset(ref_dirty, 0, sizeof(ref_dirty));
+  ref_index = 0;
+}
+
+static int check(const char *name, unsigned int src, unsigned int dst, unsigned int length, unsigned int inc, int h40)
+{
+  const char *error = NULL;
+
+  if (memcmp(vram, ref_vram, sizeof(ref_vram)))
+  {
+    error = "VRAM";
+  }
+  else if (memcmp(sat, ref_sat, sizeof(ref_sat)))
+  {
+    error = "SAT";
+  }
+  else if (memcmp(bg_name_dirty, ref_dirty, sizeof(ref_dirty)))
+  {
+    error = "pattern cache lines";
+  }
+  else if ((bg_list_index != ref_index) || memcmp(bg_name_list, ref_list, ref_index * sizeof(uint16)))
+  {
+    error = "pattern cache list";
+  }
+
+  if (error)
+  {
+    printf("%s mismatch: %s src=%04X dst=%04X length=%X inc=%d %s\n", error, name, src, dst, length, inc, h40 ? "H40" : "H32");
+    return 1;
+  }
+
+  return 0;
+}
+
+static int test_fill(unsigned int dst, unsigned int length, unsigned int inc, int h40)
+{
+  unsigned int data = rnd() & 0xFFFF;
+
+  /* 16-bit VRAM addresses */
+  dst &= 0xFFFF;
+
+  prepare(h40);
+  vdp_fill(dst, length, inc, data);
+  ref_fill(dst, length ? length : 0x10000, inc, data);
+  return check("fill", 0, dst, length, inc, h40);
+}
+
+static int test_copy(unsigned int src, unsigned int dst, unsigned int length, unsigned int inc, int h40)
+{
+  /* 16-bit VRAM addresses */
+  src &= 0xFFFF;
+  dst &= 0xFFFF;
+
+  prepare(h40);
+  vdp_copy(src, dst, length, inc);
+  ref_copy(src, dst, length ? length : 0x10000, inc);
+  return check("copy", src, dst, length, inc, h40);
+}
+
+int main(int argc, char **argv)
+{
+  int i, h40, inc, errors = 0, count = 0;
+  int iterations = (argc > 1) ? atoi(argv[1]) : 200;
+
+  /* Genesis VDP in Mode 5, display disabled, DMA enabled */
+  system_hw = SYSTEM_MD;
+  vdp_init();
+  vdp_reset();
+  fast_dma_hack = 1;
+  vdp_reg(1, 0x14);
+
+  for (i = 0; i < iterations; i++)
+  {
+    for (h40 = 0; h40 < 2; h40++)
+    {
+      unsigned int a = rnd() | ((rnd() & 1) << 15);
+      unsigned int b = rnd() | ((rnd() & 1) << 15);
+      unsigned int satb = h40 ? 0xD800 : 0xFE00;
+
+      for (inc = 0; inc < 3; inc++)
+      {
+        /* Random spans */
+        errors += test_fill(a, 1 + (rnd() & 0x1FFF), inc, h40);
+        errors += test_copy(a, b, 1 + (rnd() & 0x1FFF), inc, h40);
+        count += 2;
+      }
+
+      /* Odd start and/or end addresses */
+      errors += test_fill(a | 1, (b & 0xFFF) | 1, 1, h40);
+      errors += test_fill(a | 1, (b & 0xFFF) & ~1, 1, h40);
+      errors += test_fill(a & ~1, (b & 0xFFF) | 1, 1, h40);
+      errors += test_copy(b | 1, a | 1, (b & 0xFFF) | 1, 1, h40);
+      errors += test_copy(b & ~1, a | 1, (b & 0xFFF) & ~1, 1, h40);
+
+      /* 64K address wrap (including zero length, i.e 64K bytes) */
+      errors += test_fill(0x10000 - (a & 0xFF), 1 + (b & 0x1FF), 1, h40);
+      errors += test_fill(a, 0, 1, h40);
+      errors += test_copy(0x10000 - (a & 0xFF), b, 1 + (b & 0x1FF), 1, h40);
+      errors += test_copy(b, 0x10000 - (a & 0xFF), 1 + (b & 0x1FF), 1, h40);
+      errors += test_copy(a, b, 0, 1, h40);
+
+      /* Sprite Attribute Table overlap */
+      errors += test_fill(satb - (a & 0x3F), 1 + (b & 0x7FF), 1, h40);
+      errors += test_copy(b, satb + (a & 0x3FF) - 0x20, 1 + (b & 0xFF), 1, h40);
+      errors += test_copy(satb + (a & 0x1FF), b, 1 + (b & 0xFF), 1, h40);
+
+      /* Overlapping source and destination */
+      errors += test_copy(a, a + 1 + (b & 7), 1 + (b & 0x3FF), 1, h40);
+      errors += test_copy(a + 1 + (b & 7), a, 1 + (b & 0x3FF), 1, h40);
+      errors += test_copy(a, a + 0x40, 0x400, 1, h40);
+      errors += test_copy(a + 0x40, a, 0x400, 1, h40);
+
+      count += 17;
+    }
+  }
+
+  printf("%d tests, %d failed\n", count, errors);
+  return errors ? 1 : 0;
+}
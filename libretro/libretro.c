@@ -206,6 +206,12 @@ static char arvalidchars[] = "0123456789ABCDEF";
 static uint32_t overclock_delay;
 #endif
 
+/* Warm-start cache (snapshot capture delay in seconds, 0 = disabled) */
+static unsigned int warm_start_time = 0;
+static int warm_start_frame = -1;
+static uint32_t warm_start_key;
+static uint32_t warm_start_ram;
+
 static bool libretro_supports_option_categories = false;
 static bool libretro_supports_bitmasks          = false;
 
@@ -1034,6 +1040,7 @@ static void config_default(void)
    config.no_sprite_limit = 0;
    config.enhanced_vscroll = 0;
    config.enhanced_vscroll_limit = 8;
+   config.line_cache = 0;
 
    /* video options */
    config.overscan = 0;
@@ -1780,10 +1787,41 @@ static void check_variables(bool first_run)
   {
     if (!var.value || !strcmp(var.value, "disabled"))
       config.cd_precache = 0;
+    else if (!strcmp(var.value, "decompressed"))
+      config.cd_precache = 2;
     else
       config.cd_precache = 1;
   }
 
+  var.key = "genesis_plus_gx_warm_start";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  {
+    if (!var.value || !strcmp(var.value, "disabled"))
+      warm_start_time = 0;
+    else
+      warm_start_time = atoi(var.value);
+  }
+
+#ifdef USE_THREADS
+  var.key = "genesis_plus_gx_gfx_threads";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  {
+    if (!var.value || !strcmp(var.value, "disabled"))
+      config.gfx_threads = 0;
+    else
+      config.gfx_threads = 1;
+  }
+
+  var.key = "genesis_plus_gx_ntsc_threads";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  {
+    if (!var.value || !strcmp(var.value, "disabled"))
+      config.ntsc_threads = 0;
+    else
+      config.ntsc_threads = 1;
+  }
+#endif
+
   var.key = "genesis_plus_gx_add_on";
   environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
   {
@@ -2051,7 +2089,6 @@ static void check_variables(bool first_run)
   {
     orig_value = config.ntsc;
 
-#if 0
     if (!var.value || !strcmp(var.value, "disabled"))
       config.ntsc = 0;
     else if (var.value && !strcmp(var.value, "monochrome"))
@@ -2078,7 +2115,10 @@ static void check_variables(bool first_run)
       sms_ntsc_init(sms_ntsc, &sms_ntsc_rgb);
       md_ntsc_init(md_ntsc,   &md_ntsc_rgb);
     }
-#endif
+
+    /* cached framebuffer lines were filtered with previous tables */
+    if (config.ntsc)
+      render_line_cache_reset();
 
     if (orig_value != config.ntsc)
       update_viewports = true;
@@ -2242,6 +2282,15 @@ static void check_variables(bool first_run)
   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
     config.enhanced_vscroll_limit = strtol(var.value, NULL, 10);
 
+  var.key = "genesis_plus_gx_line_cache";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  {
+    if (!var.value || !strcmp(var.value, "disabled"))
+      config.line_cache = 0;
+    else
+      config.line_cache = 1;
+  }
+
 #ifdef USE_PER_SOUND_CHANNELS_CONFIG
   var.key = psg_channel_volume_base_str;
   for (c = 0; c < 4; c++)
@@ -2814,6 +2863,255 @@ static void set_memory_maps(void)
    }
 }
 
+/****************************************************************************
+ * Warm-start cache
+ *
+ * When enabled, a snapshot of the emulated system is taken a few seconds
+ * after a clean start (no input, no cheats, no reset nor state loading) and
+ * stored in save directory. Next launches of the same content with the same
+ * settings and save data restore it on first frame, skipping BIOS and game
+ * boot sequences.
+ ****************************************************************************/
+#define WARM_START_MAGIC "GPGXWARM"
+
+static uint32_t warm_start_ram_crc(void)
+{
+  uint32_t crc = crc32(0, sram.sram, sizeof(sram.sram));
+
+  if (system_hw == SYSTEM_MCD)
+  {
+    crc = crc32(crc, scd.bram, 0x2000);
+    if (scd.cartridge.id)
+      crc = crc32(crc, scd.cartridge.area, scd.cartridge.mask + 1);
+  }
+
+  return crc;
+}
+
+/* number of data track sectors included in Mega-CD key (system area) */
+#define WARM_START_SECTORS 16
+
+#define WARM_START_CONFIG(field) \
+  crc = crc32(crc, (const unsigned char *)&config.field, sizeof(config.field))
+
+static uint32_t warm_start_hash(void)
+{
+  uint32_t crc;
+  int i;
+
+  if (system_hw == SYSTEM_MCD)
+  {
+    /* BIOS, disc header and TOC */
+    crc = crc32(0, scd.bootrom, sizeof(scd.bootrom));
+    crc = crc32(crc, (const unsigned char *)&rominfo, sizeof(rominfo));
+    for (i = 0; i < cdd.toc.last; i++)
+    {
+      crc = crc32(crc, (const unsigned char *)&cdd.toc.tracks[i].start, sizeof(int));
+      crc = crc32(crc, (const unsigned char *)&cdd.toc.tracks[i].end, sizeof(int));
+      crc = crc32(crc, (const unsigned char *)&cdd.toc.tracks[i].type, sizeof(int));
+    }
+
+    /* data track first sectors */
+    if (cdd.loaded && cdd.toc.tracks[0].type)
+    {
+      uint8_t sector[2048];
+      int lba = cdd.lba;
+      int index = cdd.index;
+
+      cdd.index = 0;
+      for (cdd.lba = 0; cdd.lba < WARM_START_SECTORS; cdd.lba++)
+      {
+        cdd_read_data(sector, NULL);
+        crc = crc32(crc, sector, sizeof(sector));
+      }
+
+      cdd.lba = lba;
+      cdd.index = index;
+    }
+  }
+  else
+  {
+    crc = crc32(0, cart.rom, cart.romsize);
+  }
+
+  /* core settings affecting emulation */
+  WARM_START_CONFIG(hq_fm);
+  WARM_START_CONFIG(hq_psg);
+  WARM_START_CONFIG(ym2612);
+  WARM_START_CONFIG(ym2413);
+#ifdef HAVE_YM3438_CORE
+  WARM_START_CONFIG(ym3438);
+#endif
+#ifdef HAVE_OPLL_CORE
+  WARM_START_CONFIG(opll);
+#endif
+  WARM_START_CONFIG(system);
+  WARM_START_CONFIG(region_detect);
+  WARM_START_CONFIG(master_clock);
+  WARM_START_CONFIG(vdp_mode);
+  WARM_START_CONFIG(force_dtack);
+  WARM_START_CONFIG(addr_error);
+  WARM_START_CONFIG(bios);
+  WARM_START_CONFIG(lock_on);
+  WARM_START_CONFIG(add_on);
+  WARM_START_CONFIG(overscan);
+  WARM_START_CONFIG(ntsc);
+  WARM_START_CONFIG(gg_extra);
+  WARM_START_CONFIG(left_border);
+  WARM_START_CONFIG(render);
+  WARM_START_CONFIG(overclock);
+  WARM_START_CONFIG(no_sprite_limit);
+  WARM_START_CONFIG(enhanced_vscroll);
+  WARM_START_CONFIG(enhanced_vscroll_limit);
+  WARM_START_CONFIG(cd_latency);
+  for (i = 0; i < MAX_INPUTS; i++)
+  {
+    WARM_START_CONFIG(input[i].device);
+    WARM_START_CONFIG(input[i].port);
+    WARM_START_CONFIG(input[i].padtype);
+  }
+
+  /* detected hardware and save data */
+  crc = crc32(crc, &system_hw, 1);
+  crc = crc32(crc, &region_code, 1);
+  crc = crc32(crc, (const unsigned char *)&warm_start_ram, sizeof(warm_start_ram));
+
+  return crc;
+}
+
+static void warm_start_path(char *path, size_t size)
+{
+  fill_pathname_join(path, save_dir, g_rom_name, size);
+  strlcat(path, ".warm", size);
+}
+
+static void warm_start_header(uint8_t *header)
+{
+  memcpy(header, WARM_START_MAGIC, 8);
+  header[8]  = warm_start_key >> 24;
+  header[9]  = (warm_start_key >> 16) & 0xff;
+  header[10] = (warm_start_key >> 8) & 0xff;
+  header[11] = warm_start_key & 0xff;
+}
+
+static void warm_start_load(void)
+{
+  char path[256];
+  uint8_t header[12];
+  uint8_t expected[12];
+  uint8_t *state;
+  RFILE *fp;
+
+  warm_start_ram = warm_start_ram_crc();
+  warm_start_key = warm_start_hash();
+  warm_start_header(expected);
+
+  warm_start_path(path, sizeof(path));
+  fp = filestream_open(path, RETRO_VFS_FILE_ACCESS_READ, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+  if (!fp)
+    return;
+
+  if ((filestream_read(fp, header, 12) == 12) && !memcmp(header, expected, 12))
+  {
+    state = malloc(STATE_SIZE);
+    if (state)
+    {
+      if ((filestream_read(fp, state, STATE_SIZE) == STATE_SIZE) && state_load(state))
+      {
+#ifdef HAVE_OVERCLOCK
+        update_overclock();
+#endif
+        /* snapshot restored, nothing left to do */
+        warm_start_frame = -1;
+      }
+      free(state);
+    }
+  }
+
+  filestream_close(fp);
+}
+
+static void warm_start_save(void)
+{
+  char path[256];
+  char temp[256];
+  uint8_t header[12];
+  uint8_t *state;
+  RFILE *fp;
+  bool ok;
+
+  /* save data should not have been modified during boot sequence */
+  if (warm_start_ram_crc() != warm_start_ram)
+    return;
+
+  /* snapshot has fixed size, as with retro_serialize */
+  state = calloc(1, STATE_SIZE);
+  if (!state)
+    return;
+
+  state_save(state);
+  warm_start_header(header);
+
+  /* write to temporary file so that a failed write does not corrupt previous snapshot */
+  warm_start_path(path, sizeof(path));
+  strlcpy(temp, path, sizeof(temp));
+  strlcat(temp, ".tmp", sizeof(temp));
+  fp = filestream_open(temp, RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+  if (fp)
+  {
+    ok = (filestream_write(fp, header, 12) == 12);
+    ok = ok && (filestream_write(fp, state, STATE_SIZE) == STATE_SIZE);
+    ok = (filestream_close(fp) == 0) && ok;
+
+    /* replace previous snapshot (some platforms can not rename over existing file) */
+    if (ok && (filestream_rename(temp, path) != 0))
+    {
+      filestream_delete(path);
+      ok = (filestream_rename(temp, path) == 0);
+    }
+
+    if (!ok)
+      filestream_delete(temp);
+  }
+
+  free(state);
+}
+
+static void warm_start_update(void)
+{
+  int i;
+
+  /* first frame: restore snapshot if available */
+  if (warm_start_frame == 0)
+  {
+    if (!warm_start_time || maxcheats)
+    {
+      warm_start_frame = -1;
+      return;
+    }
+
+    warm_start_load();
+    if (warm_start_frame < 0)
+      return;
+  }
+
+  /* any user input cancels capture */
+  for (i = 0; i < MAX_DEVICES; i++)
+  {
+    if (input.pad[i])
+    {
+      warm_start_frame = -1;
+      return;
+    }
+  }
+
+  if (++warm_start_frame >= (int)(warm_start_time * (vdp_pal ? 50 : 60)))
+  {
+    warm_start_save();
+    warm_start_frame = -1;
+  }
+}
+
 /****************************************************************************
  * Disk control interface
  ****************************************************************************/ 
@@ -3409,6 +3707,8 @@ bool retro_unserialize(const void *data, size_t size)
    update_overclock();
 #endif
 
+   warm_start_frame = -1;
+
    return TRUE;
 }
 
@@ -3752,6 +4052,9 @@ bool retro_load_game(const struct retro_game_info *info)
 
    init_frameskip();
 
+   /* snapshot is restored or captured once save data has been loaded */
+   warm_start_frame = 0;
+
    return true;
 
 error:
@@ -3780,6 +4083,7 @@ void retro_unload_game(void)
 {
 	/* Clear disk interface */
    int i;
+   warm_start_frame = -1;
    disk_count = 0;
    disk_index = 0;
    for (i=0; i<MAX_DISKS; i++)
@@ -3795,6 +4099,9 @@ void retro_unload_game(void)
       bram_save();
 
    audio_shutdown();
+   gfx_shutdown();
+   render_shutdown();
+   md_cart_shutdown();
 
    if (md_ntsc)
       free(md_ntsc);
@@ -3924,6 +4231,7 @@ void retro_reset(void)
    overclock_delay = OVERCLOCK_FRAME_DELAY;
    update_overclock();
 #endif
+   warm_start_frame = -1;
    gen_reset(0);
 }
 
@@ -4014,6 +4322,9 @@ void retro_run(void)
     update_audio_latency = false;
   }
 
+   if (warm_start_frame >= 0)
+      warm_start_update();
+
    if (system_hw == SYSTEM_MCD)
    {
       system_frame_scd(do_skip);
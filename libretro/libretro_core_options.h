@@ -1641,6 +1641,20 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       },
       "8"
    },
+   {
+      "genesis_plus_gx_line_cache",
+      "Skip Unchanged Lines",
+      NULL,
+      "Reuse the previous frame's output for Mega Drive/Genesis scanlines whose registers, scroll values, sprites, VRAM and palette did not change. Speeds up static scenes (menus, dialogues, paused games).",
+      NULL,
+      "hacks",
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
 #ifdef HAVE_OVERCLOCK
    {
       "genesis_plus_gx_overclock",
@@ -1718,7 +1732,39 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       "genesis_plus_gx_cd_precache",
       "CD Image Cache",
       NULL,
-      "Load CD image to memory on startup. CHD supported only. Restart Required.",
+      "Load CD image to memory on startup. CHD supported only. 'Enabled' keeps the compressed image in memory, 'Decompressed' decompresses the whole image in memory using all CPU cores (requires as much memory as the uncompressed image). Restart Required.",
+      NULL,
+      "hacks",
+      {
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "genesis_plus_gx_warm_start",
+      "Warm-Start Cache",
+      NULL,
+      "Save a snapshot of the system a few seconds after startup in save directory and restore it on next launches of the same content, skipping BIOS and game boot sequences. Snapshot is only taken if no input was received and save data was not modified. Changing any core setting or save data invalidates it.",
+      NULL,
+      "hacks",
+      {
+         { "disabled", NULL },
+         { "2",        "2 Seconds" },
+         { "5",        "5 Seconds" },
+         { "10",       "10 Seconds" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+#ifdef USE_THREADS
+   {
+      "genesis_plus_gx_gfx_threads",
+      "CD Graphics Multithreading",
+      NULL,
+      "Render Mega CD rotation/scaling graphics lines using multiple CPU cores.",
       NULL,
       "hacks",
       {
@@ -1728,6 +1774,21 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       },
       "disabled"
    },
+   {
+      "genesis_plus_gx_ntsc_threads",
+      "NTSC Filter Multithreading",
+      NULL,
+      "Apply Blargg NTSC filter to frame lines using multiple CPU cores.",
+      NULL,
+      "hacks",
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+#endif
 #ifdef USE_PER_SOUND_CHANNELS_CONFIG
    {
       "genesis_plus_gx_show_advanced_audio_settings",
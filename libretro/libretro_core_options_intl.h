@@ -1146,8 +1146,9 @@ struct retro_core_option_v2_definition option_defs_ar[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -2722,8 +2723,9 @@ struct retro_core_option_v2_definition option_defs_ast[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -4298,8 +4300,9 @@ struct retro_core_option_v2_definition option_defs_be[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -5874,8 +5877,9 @@ struct retro_core_option_v2_definition option_defs_bg[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -7450,8 +7454,9 @@ struct retro_core_option_v2_definition option_defs_ca[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -9026,8 +9031,9 @@ struct retro_core_option_v2_definition option_defs_chs[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -10602,8 +10608,9 @@ struct retro_core_option_v2_definition option_defs_cht[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -12178,8 +12185,9 @@ struct retro_core_option_v2_definition option_defs_cs[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -13754,8 +13762,9 @@ struct retro_core_option_v2_definition option_defs_cy[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -15330,8 +15339,9 @@ struct retro_core_option_v2_definition option_defs_da[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -16906,8 +16916,9 @@ struct retro_core_option_v2_definition option_defs_de[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -18482,8 +18493,9 @@ struct retro_core_option_v2_definition option_defs_el[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -20058,8 +20070,9 @@ struct retro_core_option_v2_definition option_defs_en[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -21634,8 +21647,9 @@ struct retro_core_option_v2_definition option_defs_eo[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -23210,8 +23224,9 @@ struct retro_core_option_v2_definition option_defs_es[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -24786,8 +24801,9 @@ struct retro_core_option_v2_definition option_defs_fa[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -26362,8 +26378,9 @@ struct retro_core_option_v2_definition option_defs_fi[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -27938,8 +27955,9 @@ struct retro_core_option_v2_definition option_defs_fr[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -29514,8 +29532,9 @@ struct retro_core_option_v2_definition option_defs_gl[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -31090,8 +31109,9 @@ struct retro_core_option_v2_definition option_defs_he[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -32666,8 +32686,9 @@ struct retro_core_option_v2_definition option_defs_hr[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -34242,8 +34263,9 @@ struct retro_core_option_v2_definition option_defs_hu[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -35818,8 +35840,9 @@ struct retro_core_option_v2_definition option_defs_id[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -37394,8 +37417,9 @@ struct retro_core_option_v2_definition option_defs_it[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -38970,8 +38994,9 @@ struct retro_core_option_v2_definition option_defs_ja[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -40546,8 +40571,9 @@ struct retro_core_option_v2_definition option_defs_ko[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -42122,8 +42148,9 @@ struct retro_core_option_v2_definition option_defs_nl[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -43698,8 +43725,9 @@ struct retro_core_option_v2_definition option_defs_no[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -45274,8 +45302,9 @@ struct retro_core_option_v2_definition option_defs_or[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -46850,8 +46879,9 @@ struct retro_core_option_v2_definition option_defs_pl[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -48426,8 +48456,9 @@ struct retro_core_option_v2_definition option_defs_pt_br[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -50002,8 +50033,9 @@ struct retro_core_option_v2_definition option_defs_pt_pt[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -51578,8 +51610,9 @@ struct retro_core_option_v2_definition option_defs_ru[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -53154,8 +53187,9 @@ struct retro_core_option_v2_definition option_defs_sk[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -54730,8 +54764,9 @@ struct retro_core_option_v2_definition option_defs_sr[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -56306,8 +56341,9 @@ struct retro_core_option_v2_definition option_defs_sv[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -57882,8 +57918,9 @@ struct retro_core_option_v2_definition option_defs_tr[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -59458,8 +59495,9 @@ struct retro_core_option_v2_definition option_defs_tt[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -61034,8 +61072,9 @@ struct retro_core_option_v2_definition option_defs_uk[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -62610,8 +62649,9 @@ struct retro_core_option_v2_definition option_defs_val[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -64186,8 +64226,9 @@ struct retro_core_option_v2_definition option_defs_vn[] = {
       NULL,
       "hacks",
       {
-         { "disabled", NULL },
-         { "enabled",  NULL },
+         { "disabled",     NULL },
+         { "enabled",      NULL },
+         { "decompressed", NULL },
          { NULL, NULL },
       },
       "disabled"
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *  lutgen.c
+ *
+ *  Genesis Plus GX libretro port
+ *
+ *  Build-time generator for rendering look-up tables (USE_STATIC_LUTS)
+ *
+ *  This file is distributed under the same terms as Genesis Plus GX
+ *  (see LICENSE.txt).
+ *
+ ****************************************************************************/
+
+/* This tool is built and run on the host when building with STATIC_LUTS=1  */
+/* (see Makefile.libretro). It generates vdp_lut_data.h with the look-up     */
+/* tables that vdp_render.c otherwise initializes at startup, so that they   */
+/* end up in read-only data shared between all running instances.           */
+
+#include <stdio.h>
+
+#include "types.h"
+#include "vdp_lut.h"
+
+static uint8 name_lut[0x400];
+static uint8 lut[LUT_MAX][LUT_SIZE];
+
+static void write_table(FILE *fd, const uint8 *data, int size, const char *indent)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+  {
+    if ((i & 15) == 0)
+      fprintf(fd, "%s", indent);
+
+    fprintf(fd, "0x%02X,", data[i]);
+
+    if ((i & 15) == 15)
+      fprintf(fd, "\n");
+  }
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+  FILE *fd;
+
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s <output file>\n", argv[0]);
+    return 1;
+  }
+
+  /* Initialize look-up tables */
+  make_lut(lut);
+  make_name_lut(name_lut);
+
+  fd = fopen(argv[1], "w");
+  if (!fd)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  fprintf(fd, "/* Generated by libretro/lutgen.c, do not edit */\n\n");
+
+  fprintf(fd, "/* Sprite pattern name offset look-up table (Mode 5) */\n");
+  fprintf(fd, "static const uint8 name_lut[0x400] =\n{\n");
+  write_table(fd, name_lut, 0x400, "  ");
+  fprintf(fd, "};\n\n");
+
+  fprintf(fd, "/* Layer priority pixel look-up tables */\n");
+  fprintf(fd, "static const uint8 lut[LUT_MAX][LUT_SIZE] =\n{\n");
+  for (i = 0; i < LUT_MAX; i++)
+  {
+    fprintf(fd, "  {\n");
+    write_table(fd, lut[i], LUT_SIZE, "    ");
+    fprintf(fd, "  },\n");
+  }
+  fprintf(fd, "};\n");
+
+  if (fclose(fd) != 0)
+  {
+    perror(argv[1]);
+    remove(argv[1]);
+    return 1;
+  }
+
+  return 0;
+}
@@ -135,8 +135,13 @@ typedef struct
   uint8 no_sprite_limit;
   uint8 enhanced_vscroll;
   uint8 enhanced_vscroll_limit;
+  uint8 line_cache;
   uint8 cd_latency;
-  bool cd_precache;
+  uint8 cd_precache;
+#ifdef USE_THREADS
+  uint8 gfx_threads;
+  uint8 ntsc_threads;
+#endif
 #ifdef USE_PER_SOUND_CHANNELS_CONFIG
   unsigned int psg_ch_volumes[4];
   int32 md_ch_volumes[6];
@@ -161,6 +166,7 @@ extern char MS_BIOS_JP[256];
 
 extern void osd_input_update(void);
 extern int load_archive(char *filename, unsigned char *buffer, int maxsize, char *extension);
+#define load_bios_archive load_archive /* BIOS & Lock-On ROM files are not cached */
 extern void ROMCheatUpdate(void);
 extern retro_log_printf_t log_cb;
 
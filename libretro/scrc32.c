@@ -97,17 +97,42 @@ static const unsigned long crc_table[256] = {
 };
 
 #define DO1_CRC32(buf) crc = crc_table[((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
-#define DO2_CRC32(buf) DO1_CRC32(buf); DO1_CRC32(buf);
-#define DO4_CRC32(buf) DO2_CRC32(buf); DO2_CRC32(buf);
-#define DO8_CRC32(buf) DO4_CRC32(buf); DO4_CRC32(buf);
+
+/* slicing-by-8 tables, generated from crc_table on first use */
+static unsigned long crc_slice[8][256];
+static int crc_slice_init = 0;
+
+static void crc32_init(void)
+{
+	int i, j;
+	for (i = 0; i < 256; i++)
+	{
+		unsigned long crc = crc_table[i];
+		crc_slice[0][i] = crc;
+		for (j = 1; j < 8; j++)
+		{
+			crc = crc_table[crc & 0xff] ^ (crc >> 8);
+			crc_slice[j][i] = crc;
+		}
+	}
+	crc_slice_init = 1;
+}
 
 unsigned long crc32(unsigned long crc, const unsigned char *buf, unsigned int len)
 {
 	if (buf == 0) return 0L;
+	if (!crc_slice_init) crc32_init();
 	crc = crc ^ 0xffffffffL;
 	while (len >= 8)
 	{
-	DO8_CRC32(buf);
+	/* process 8 bytes at once (independent table lookups) */
+	unsigned long lo = crc ^ (buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((unsigned long)buf[3] << 24));
+	unsigned long hi = buf[4] | (buf[5] << 8) | (buf[6] << 16) | ((unsigned long)buf[7] << 24);
+	crc = crc_slice[7][lo & 0xff] ^ crc_slice[6][(lo >> 8) & 0xff] ^
+	      crc_slice[5][(lo >> 16) & 0xff] ^ crc_slice[4][(lo >> 24) & 0xff] ^
+	      crc_slice[3][hi & 0xff] ^ crc_slice[2][(hi >> 8) & 0xff] ^
+	      crc_slice[1][(hi >> 16) & 0xff] ^ crc_slice[0][(hi >> 24) & 0xff];
+	buf += 8;
 	len -= 8;
 	}
 	if (len) do {
@@ -44,5 +44,6 @@
 
 /* Function prototypes */
 extern int load_archive(char *filename, unsigned char *buffer, int maxsize, char *extension);
+#define load_bios_archive load_archive /* BIOS & Lock-On ROM files are not cached */
 
 #endif /* _FILEIO_H_ */
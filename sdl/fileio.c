@@ -42,9 +42,85 @@
 
 #include "shared.h"
 #include <zlib.h>
+#include <sys/stat.h>
+
+/* BIOS & Lock-On ROM files are reloaded each time a game is loaded, */
+/* they are kept in memory until their modification time changes    */
+#define BIOS_CACHE_ENTRIES 8
+
+static struct
+{
+  char path[256];
+  time_t mtime;
+  off_t filesize;
+  int maxsize;
+  int size;
+  char extension[4];
+  unsigned char *data;
+} bios_cache[BIOS_CACHE_ENTRIES];
+
+static int bios_cache_next;
 
 static int check_zip(char *filename);
 
+static int bios_cache_load(char *filename, struct stat *st, unsigned char *buffer, int maxsize, char *extension)
+{
+  int i;
+
+  for (i = 0; i < BIOS_CACHE_ENTRIES; i++)
+  {
+    if (bios_cache[i].data && (bios_cache[i].mtime == st->st_mtime) && (bios_cache[i].filesize == st->st_size) &&
+        (bios_cache[i].maxsize == maxsize) && !strcmp(bios_cache[i].path, filename))
+    {
+      memcpy(buffer, bios_cache[i].data, bios_cache[i].size);
+
+      if (extension)
+      {
+        memcpy(extension, bios_cache[i].extension, 4);
+      }
+
+      return bios_cache[i].size;
+    }
+  }
+
+  return 0;
+}
+
+static void bios_cache_store(char *filename, struct stat *st, unsigned char *buffer, int maxsize, int size, char *extension)
+{
+  int i;
+
+  if (strlen(filename) >= sizeof(bios_cache[0].path)) return;
+
+  /* replace existing entry for this file or oldest entry */
+  for (i = 0; i < BIOS_CACHE_ENTRIES; i++)
+  {
+    if (bios_cache[i].data && !strcmp(bios_cache[i].path, filename)) break;
+  }
+
+  if (i == BIOS_CACHE_ENTRIES)
+  {
+    i = bios_cache_next;
+    bios_cache_next = (bios_cache_next + 1) % BIOS_CACHE_ENTRIES;
+  }
+
+  free(bios_cache[i].data);
+  bios_cache[i].data = malloc(size);
+  if (!bios_cache[i].data) return;
+
+  memcpy(bios_cache[i].data, buffer, size);
+  strcpy(bios_cache[i].path, filename);
+  bios_cache[i].mtime = st->st_mtime;
+  bios_cache[i].filesize = st->st_size;
+  bios_cache[i].maxsize = maxsize;
+  bios_cache[i].size = size;
+  memset(bios_cache[i].extension, 0, 4);
+  if (extension)
+  {
+    memcpy(bios_cache[i].extension, extension, 4);
+  }
+}
+
 int load_archive(char *filename, unsigned char *buffer, int maxsize, char *extension)
 {
   int size = 0;
@@ -142,6 +218,32 @@ int load_archive(char *filename, unsigned char *buffer, int maxsize, char *exten
   return size;
 }
 
+/* BIOS & Lock-On ROM files are kept in memory */
+int load_bios_archive(char *filename, unsigned char *buffer, int maxsize, char *extension)
+{
+  struct stat st;
+  int size;
+
+  if (stat(filename, &st))
+  {
+    return 0;
+  }
+
+  size = bios_cache_load(filename, &st, buffer, maxsize, extension);
+  if (size > 0)
+  {
+    return size;
+  }
+
+  size = load_archive(filename, buffer, maxsize, extension);
+  if (size > 0)
+  {
+    bios_cache_store(filename, &st, buffer, maxsize, size, extension);
+  }
+
+  return size;
+}
+
 /*
     Verifies if a file is a ZIP archive or not.
     Returns: 1= ZIP archive, 0= not a ZIP archive
@@ -151,7 +253,11 @@ static int check_zip(char *filename)
   uint8 buf[2];
   FILE *fd = fopen(filename, "rb");
   if(!fd) return (0);
-  fread(buf, 2, 1, fd);
+  if(fread(buf, 2, 1, fd) != 1)
+  {
+    fclose(fd);
+    return (0);
+  }
   fclose(fd);
   if(memcmp(buf, "PK", 2) == 0) return (1);
   return (0);
@@ -44,5 +44,6 @@
 
 /* Function prototypes */
 extern int load_archive(char *filename, unsigned char *buffer, int maxsize, char *extension);
+extern int load_bios_archive(char *filename, unsigned char *buffer, int maxsize, char *extension);
 
 #endif /* _FILEIO_H_ */